@@ -0,0 +1,969 @@
+#include "cvplot.h"
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+struct BenchResult
+{
+	std::string name;
+	double ms;
+	double mbps;
+};
+
+static std::vector<BenchResult> results__;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double file_size_mb(const std::string& filename)
+{
+	FILE* fp = cvplot::util::OpenFile(filename, "rb");
+	if (fp == nullptr)
+	{
+		return 0;
+	}
+	fseek(fp, 0, SEEK_END);
+	auto size = ftell(fp);
+	fclose(fp);
+	return size / (1024.0 * 1024.0);
+}
+
+static void report(const std::string& name, double ms, double mb = 0)
+{
+	results__.push_back({ name, ms, mb > 0 ? mb / (ms / 1000.0) : 0 });
+	std::cout << name << ": " << ms << " ms";
+	if (mb > 0)
+	{
+		std::cout << ", " << results__.back().mbps << " MB/s";
+	}
+	std::cout << std::endl;
+}
+
+static std::vector<double> random_values(cvplot::chart::Type type, int samples)
+{
+	std::mt19937_64 rng(42);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	auto dim = cvplot::chart::GetDimension(type);
+	std::vector<double> values((size_t)samples * dim);
+	double y = 0;
+	for (int i = 0; i < samples; ++i)
+	{
+		y += dist(rng);
+		if (dim == 1)
+		{
+			values[i] = y;
+		}
+		else
+		{
+			values[(size_t)i * dim] = i;
+			values[(size_t)i * dim + 1] = y;
+			if (dim == 3)
+			{
+				values[(size_t)i * dim + 2] = dist(rng);
+			}
+		}
+	}
+	return values;
+}
+
+static cvplot::Series random_series(const std::string& label, cvplot::chart::Type type, int samples)
+{
+	return cvplot::Series(label, type).AddValues(random_values(type, samples));
+}
+
+//! best of runs renders of view (invalidated before each one)
+static double render_ms(cvplot::View& view, int runs, cvplot::quality::Type quality = cvplot::quality::Full)
+{
+	double best = DBL_MAX;
+	for (int i = 0; i < runs; ++i)
+	{
+		view.Invalidate();
+		auto start = std::chrono::steady_clock::now();
+		view.Render(quality);
+		best = std::min(best, elapsed_ms(start));
+	}
+	return best;
+}
+
+//! View::Render of single chart types: 10k/1M/10M Line, 1M Scatter per marker,
+//! 1000x1000 Elevation, 100 Bar series, 1k/100k bars, and the composite of a 4x4
+//! Figure (plain, 2x supersampled)
+static void bench_render()
+{
+	const cv::Size SIZE = { 1280,720 };
+	struct
+	{
+		const char* name;
+		int samples;
+		int runs;
+	} lines[] =
+	{
+		{ "render_line_10k", 10000, 10 },
+		{ "render_line_1M", 1000000, 5 },
+		{ "render_line_10M", 10000000, 3 },
+	};
+	for (auto& line : lines)
+	{
+		cvplot::View view("line", SIZE);
+		view.AddSeries(random_series("s", cvplot::chart::Line, line.samples));
+		report(line.name, render_ms(view, line.runs));
+	}
+
+	const char* markers[] = { "none", "cross", "plus", "star", "circle", "square", "diamond" };
+	auto points = random_values(cvplot::chart::Scatter, 1000000);
+	for (cvplot::marker::Type marker = cvplot::marker::None; marker <= cvplot::marker::Diamond; ++marker)
+	{
+		cvplot::View view("scatter", SIZE);
+		view.AddSeries(cvplot::Series("s", cvplot::chart::Scatter, marker).AddValues(points));
+		report(std::string("render_scatter_1M_") + markers[marker], render_ms(view, 3));
+	}
+
+	{
+		const int N = 1000;
+		std::vector<double> cells((size_t)N * N * 3);
+		for (int i = 0; i < N; ++i)
+		{
+			for (int j = 0; j < N; ++j)
+			{
+				auto p = &cells[((size_t)i * N + j) * 3];
+				p[0] = i;
+				p[1] = j;
+				p[2] = std::sin(i * 0.01) * std::cos(j * 0.01);
+			}
+		}
+		cvplot::View view("elevation", SIZE);
+		view.AddSeries(cvplot::Series("s", cvplot::chart::Elevation).AddValues(cells));
+		report("render_elevation_1000x1000", render_ms(view, 1));
+	}
+
+	{
+		cvplot::View view("bar", SIZE);
+		for (int i = 0; i < 100; ++i)
+		{
+			view.AddSeries(random_series("b" + std::to_string(i), cvplot::chart::Bar, 10));
+		}
+		report("render_bar_100x10", render_ms(view, 5));
+	}
+
+	for (int bars : { 1000, 100000 })
+	{
+		cvplot::View view("bar", SIZE);
+		view.AddSeries(random_series("b", cvplot::chart::Bar, bars));
+		report("render_bar_" + std::to_string(bars / 1000) + "k", render_ms(view, 3));
+	}
+
+	for (int ss = 1; ss <= 2; ++ss)
+	{
+		const int FRAMES = 5;
+		cvplot::Figure figure(false);
+		figure.SetLayout(4, 4).SetSize({ 1920,1080 }).SetSupersampling(ss);
+		for (int r = 1; r <= 4; ++r)
+		{
+			for (int c = 1; c <= 4; ++c)
+			{
+				auto& view = figure.SelectView(r, c);
+				view.SetTitle("view");
+				view.AddSeries(random_series("s", cvplot::chart::Line, 100000));
+			}
+		}
+		figure.Refresh();
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < FRAMES; ++i)
+		{
+			for (int r = 1; r <= 4; ++r)
+			{
+				for (int c = 1; c <= 4; ++c)
+				{
+					figure.SelectView(r, c).Invalidate();
+				}
+			}
+			figure.Refresh();
+		}
+		auto name = std::string("render_figure_4x4") + (ss > 1 ? "_ss" + std::to_string(ss) : "");
+		report(name, elapsed_ms(start) / FRAMES);
+		std::cout << name << " memory " << figure.GetMemory() / 1048576.0 << " MB" << std::endl;
+		figure.Close();
+	}
+}
+
+//! DumpText/LoadText of a 10M-sample series, against the former printf/scanf codec
+static void bench_text_codec()
+{
+	const int N = 10000000;
+	auto s = random_series("text", cvplot::chart::Trends, N);
+	s.Dump("bench_text.sdp");
+
+	auto start = std::chrono::steady_clock::now();
+	s.DumpText("bench_text.sdp.txt");
+	auto ms = elapsed_ms(start);
+	auto mb = file_size_mb("bench_text.sdp.txt");
+	report("text_dump_10M", ms, mb);
+
+	cvplot::Series t;
+	t.Load("bench_text.sdp");
+	start = std::chrono::steady_clock::now();
+	t.LoadText("bench_text.sdp.txt", true);
+	report("text_load_10M", elapsed_ms(start), mb);
+	if (t.GetSampleCount() != N)
+	{
+		std::cout << "text_load_10M: sample count mismatch" << std::endl;
+	}
+
+	auto values = random_values(cvplot::chart::Trends, N);
+	start = std::chrono::steady_clock::now();
+	FILE* fp = cvplot::util::OpenFile("bench_text_printf.txt", "w");
+	for (int i = 0; i < N; ++i)
+	{
+		fprintf(fp, "%g \n", values[i]);
+	}
+	fclose(fp);
+	report("text_dump_10M_printf", elapsed_ms(start), file_size_mb("bench_text_printf.txt"));
+
+	start = std::chrono::steady_clock::now();
+	fp = cvplot::util::OpenFile("bench_text.sdp.txt", "r");
+	for (int i = 0; i < N; ++i)
+	{
+		if (fscanf(fp, "%lf", &values[i]) != 1)
+		{
+			break;
+		}
+	}
+	fclose(fp);
+	report("text_load_10M_scanf", elapsed_ms(start), mb);
+
+	std::remove("bench_text.sdp");
+	std::remove("bench_text.sdp.txt");
+	std::remove("bench_text_printf.txt");
+}
+
+//! gorilla encode/decode of 10M (x, y) samples: evenly spaced x with a slowly
+//! changing y (2 decimals, like sensor readings) and with a full precision random walk
+static void bench_gorilla()
+{
+	const int N = 10000000;
+	auto walk = random_values(cvplot::chart::Line, N);
+	std::vector<double> sensor((size_t)N * 2);
+	for (int i = 0; i < N; ++i)
+	{
+		sensor[2 * i] = 1000.0 + 10.0 * i;
+		sensor[2 * i + 1] = std::round(2000.0 * std::sin(i / 5000.0) + 100 * std::sin(i / 37.0)) / 100.0;
+	}
+
+	struct
+	{
+		const char* name;
+		std::vector<double>* values;
+	} inputs[] = { { "gorilla_sensor_10M", &sensor }, { "gorilla_walk_10M", &walk } };
+
+	for (auto& input : inputs)
+	{
+		auto raw_mb = input.values->size() * sizeof(double) / (1024.0 * 1024.0);
+		auto start = std::chrono::steady_clock::now();
+		auto encoded = cvplot::gorilla::Encode(input.values->data(), N, 2);
+		report(std::string(input.name) + "_encode", elapsed_ms(start), raw_mb);
+
+		std::vector<double> decoded;
+		start = std::chrono::steady_clock::now();
+		cvplot::gorilla::Decode(encoded.data(), encoded.size(), decoded);
+		report(std::string(input.name) + "_decode", elapsed_ms(start), raw_mb);
+
+		std::cout << input.name << ": ratio " << raw_mb * 1024 * 1024 / encoded.size()
+			<< (decoded.size() == input.values->size()
+				&& memcmp(decoded.data(), input.values->data(), decoded.size() * sizeof(double)) == 0 ? "" : " (round-trip mismatch)") << std::endl;
+	}
+}
+
+//! Figure::Dump/Load of a 4x4 figure holding 4 series of 500k (x, y) samples per view
+static void bench_figure_dump()
+{
+	const int N = 500000;
+	cvplot::Figure figure(false);
+	figure.SetLayout(4, 4);
+	for (int r = 1; r <= 4; ++r)
+	{
+		for (int c = 1; c <= 4; ++c)
+		{
+			auto& view = figure.SelectView(r, c);
+			for (int i = 0; i < 4; ++i)
+			{
+				view.AddSeries(random_series("s" + std::to_string(i), cvplot::chart::Line, N));
+			}
+		}
+	}
+	auto mb = 16 * 4 * N * 2 * sizeof(double) / (1024.0 * 1024.0);
+
+	auto start = std::chrono::steady_clock::now();
+	figure.Dump("", "bench_fig");
+	report("figure_dump_16x4x500k", elapsed_ms(start), mb);
+
+	cvplot::Figure loaded(false);
+	start = std::chrono::steady_clock::now();
+	loaded.Load("", "bench_fig", true);
+	report("figure_load_16x4x500k", elapsed_ms(start), mb);
+	if (loaded.SelectView(4, 4).SelectSeries("s3").GetSampleCount() != N)
+	{
+		std::cout << "figure_load_16x4x500k: sample count mismatch" << std::endl;
+	}
+
+	std::remove("bench_fig.00000000000000.fdp");
+	for (int r = 1; r <= 4; ++r)
+	{
+		for (int c = 1; c <= 4; ++c)
+		{
+			char sz[32] = { 0 };
+			snprintf(sz, sizeof(sz), "bench_fig.%02d-%02d", r, c);
+			std::string prefix = sz;
+			std::remove((prefix + ".000000000.vdp").c_str());
+			for (int i = 1; i <= 4; ++i)
+			{
+				snprintf(sz, sizeof(sz), ".%09d.sdp", i);
+				std::remove((prefix + sz).c_str());
+				std::remove((prefix + sz + ".txt").c_str());
+				std::remove((prefix + sz + ".bin").c_str());
+			}
+		}
+	}
+}
+
+//! per-call cost of metric::Record (interned id and string literal) while a flusher
+//! drains into a view, against appending to a mutex-guarded map of vectors
+static void bench_metric()
+{
+	const int N = 20000000;
+	const int M = cvplot::metric::detail::Ring::CAPACITY / 2;
+	auto flusher = std::make_shared<cvplot::metric::Flusher>(cvplot::chart::Line, 5, 1 << 20);
+	cvplot::View view("metrics", { 800,600 });
+	view.AddSource(flusher);
+
+	auto id = cvplot::metric::Intern("bench_id");
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < N; i += M)
+	{
+		for (int j = 0; j < M; ++j)
+		{
+			cvplot::metric::Record(id, j);
+		}
+		flusher->Flush();
+		view.Drain();
+	}
+	auto ms = elapsed_ms(start);
+	report("metric_record_id_20M", ms);
+	std::cout << "metric_record_id_20M: " << ms * 1e6 / N << " ns/call (incl. flush)" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	for (int j = 0; j < M; ++j)
+	{
+		cvplot::metric::Record(id, j);
+	}
+	ms = elapsed_ms(start);
+	std::cout << "metric_record_id_burst: " << ms * 1e6 / M << " ns/call" << std::endl;
+	flusher->Flush();
+
+	uint64_t sum = 0;
+	start = std::chrono::steady_clock::now();
+	for (int j = 0; j < M; ++j)
+	{
+		sum += cvplot::metric::Ticks();
+	}
+	ms = elapsed_ms(start);
+	std::cout << "metric_ticks_only: " << ms * 1e6 / M << " ns/call" << (sum == 0 ? " " : "") << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	for (int j = 0; j < M; ++j)
+	{
+		cvplot::metric::Record("bench_literal", j);
+	}
+	ms = elapsed_ms(start);
+	std::cout << "metric_record_literal_burst: " << ms * 1e6 / M << " ns/call" << std::endl;
+	flusher->Flush();
+	view.Drain();
+
+	std::mutex mtx;
+	std::map<std::string, std::vector<std::pair<double, double>>> naive;
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < N; ++i)
+	{
+		auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+		std::lock_guard<std::mutex> lock(mtx);
+		naive["bench_naive"].push_back({ (double)now, (double)i });
+	}
+	ms = elapsed_ms(start);
+	report("metric_naive_map_20M", ms);
+	std::cout << "metric_naive_map_20M: " << ms * 1e6 / N << " ns/call" << std::endl;
+
+	std::cout << "metric: " << view.SelectSeries("bench_id").GetSampleCount() << " samples in view, "
+		<< flusher->GetDropped() << " dropped" << std::endl;
+}
+
+//! mouse hover on a 3x4 figure (4 series of 100k samples per view): events handled one
+//! by one (no frame loop running) and bursts of 20 events coalesced into one frame
+static void bench_hover()
+{
+	const int EVENTS = 2000;
+	const int BURST = 20;
+	cvplot::Figure figure(false);
+	figure.SetLayout(3, 4).SetSize({ 1920,1080 });
+	for (int r = 1; r <= 3; ++r)
+	{
+		for (int c = 1; c <= 4; ++c)
+		{
+			auto& view = figure.SelectView(r, c);
+			view.SetTitle("view");
+			for (int i = 0; i < 4; ++i)
+			{
+				view.AddSeries(random_series("s" + std::to_string(i), cvplot::chart::Line, 100000));
+			}
+		}
+	}
+	figure.EnableMouseMove(true);
+	figure.Refresh();
+	std::string window = "bench_hover";
+
+	auto start = std::chrono::steady_clock::now();
+	figure.Close();
+	for (int i = 0; i < EVENTS; ++i)
+	{
+		figure.OnMouseMove(100 + i % 1700, 100 + (i * 7) % 850, window);
+	}
+	auto ms = elapsed_ms(start);
+	report("hover_immediate_2000", ms);
+	std::cout << "hover_immediate: " << ms * 1000 / EVENTS << " us/event" << std::endl;
+
+	figure.Refresh();
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < EVENTS; ++i)
+	{
+		figure.OnMouseMove(100 + i % 1700, 100 + (i * 7) % 850, window);
+		if (i % BURST == BURST - 1)
+		{
+			figure.Refresh();
+		}
+	}
+	ms = elapsed_ms(start);
+	report("hover_coalesced_2000", ms);
+	std::cout << "hover_coalesced: " << ms * 1000 / EVENTS << " us/event, "
+		<< ms * 1000 * BURST / EVENTS << " us/frame" << std::endl;
+}
+
+//! render a 10M-sample Line view in full, then zoomed to 1000 samples and panned
+static void bench_zoom()
+{
+	const int SAMPLES = 10000000;
+	const int FRAMES = 20;
+	cvplot::View view("zoom", { 1280,720 });
+	view.AddSeries(random_series("s", cvplot::chart::Line, SAMPLES));
+
+	auto start = std::chrono::steady_clock::now();
+	view.Render();
+	report("zoom_full_render_10M", elapsed_ms(start));
+
+	auto viewport = view.GetViewport();
+	double x0 = SAMPLES / 2;
+	view.SetViewport(x0, x0 + 1000, viewport[2], viewport[3]);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		view.Pan(10, 0).Render();
+	}
+	report("zoom_pan_render_1k_x20", elapsed_ms(start));
+
+	view.SetViewport(0, SAMPLES / 10, viewport[2], viewport[3]);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		view.Pan(10, 0).Render();
+	}
+	report("zoom_pan_render_1M_x20", elapsed_ms(start));
+}
+
+//! bounds, 100 range queries and a zoomed-out render of a 10M-sample line, scan vs pyramid
+static void bench_pyramid()
+{
+	const int SAMPLES = 10000000;
+	const int QUERIES = 100;
+	auto scan = random_series("s", cvplot::chart::Line, SAMPLES);
+	auto indexed = scan;
+	indexed.EnablePyramid();
+
+	for (auto series : { &scan, &indexed })
+	{
+		auto name = std::string(series->HasPyramid() ? "pyramid" : "scan");
+		auto start = std::chrono::steady_clock::now();
+		series->CalcMin();
+		series->CalcMax();
+		report(name + "_bounds_first", elapsed_ms(start));
+
+		start = std::chrono::steady_clock::now();
+		series->CalcMin();
+		series->CalcMax();
+		report(name + "_bounds", elapsed_ms(start));
+
+		std::mt19937_64 rng(7);
+		std::vector<double> mins;
+		std::vector<double> maxs;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < QUERIES; ++i)
+		{
+			auto x0 = (double)(rng() % SAMPLES);
+			series->CalcRange(x0, x0 + SAMPLES / 4, mins, maxs);
+		}
+		report(name + "_range_x100", elapsed_ms(start));
+
+		cvplot::View view("pyramid", { 1280,720 });
+		view.AddSeries(*series);
+		view.Render();
+		start = std::chrono::steady_clock::now();
+		view.SetViewport(0, SAMPLES / 2, mins[1], maxs[1]).Render();
+		report(name + "_render_5M", elapsed_ms(start));
+	}
+}
+
+//! stage breakdown of a 3x4 figure render (4 series of 100k samples per view), frame time
+//! with profiling off and on, and a Chrome trace of one frame in bench_trace.json
+static void bench_profile()
+{
+	const int FRAMES = 10;
+	cvplot::Figure figure(false);
+	figure.SetLayout(3, 4).SetSize({ 1920,1080 });
+	for (int r = 1; r <= 3; ++r)
+	{
+		for (int c = 1; c <= 4; ++c)
+		{
+			auto& view = figure.SelectView(r, c);
+			view.SetTitle("view").SetXLabel("x").SetYLabel("y").EnableGrid(true);
+			for (int i = 0; i < 4; ++i)
+			{
+				view.AddSeries(random_series("s" + std::to_string(i), cvplot::chart::Line, 100000));
+			}
+		}
+	}
+
+	auto frames = [&](const char* name)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < FRAMES; ++i)
+		{
+			for (int r = 1; r <= 3; ++r)
+			{
+				for (int c = 1; c <= 4; ++c)
+				{
+					figure.SelectView(r, c).Invalidate();
+				}
+			}
+			figure.Refresh();
+		}
+		report(name, elapsed_ms(start) / FRAMES);
+	};
+	figure.Refresh();
+	frames("profile_frame_off");
+	figure.EnableProfiling(true);
+	frames("profile_frame_on");
+
+	auto trace = std::make_shared<cvplot::profile::Trace>();
+	figure.EnableProfiling(true, trace);
+	frames("profile_frame_trace");
+	trace->Clear();
+	figure.SelectView(1, 2).Invalidate();
+	figure.Refresh();
+	trace->Write("bench_trace.json");
+
+	auto& f = figure.GetRenderStats();
+	std::cout << "figure: render " << f.render << " resize " << f.resize
+		<< " copy " << f.copy << " total " << f.total << " ms" << std::endl;
+	auto& v = figure.SelectView(1, 2).GetRenderStats();
+	std::cout << "view: prepare " << v.prepare << " clear " << v.clear << " ylabel " << v.ylabel
+		<< " bounds " << v.bounds << " grid " << v.grid << " series " << v.series << " legend " << v.legend
+		<< " colorbar " << v.colorbar << " title " << v.title << " xlabel " << v.xlabel
+		<< " total " << v.total << " ms" << std::endl;
+}
+
+//! draft against full renders of 2M-sample views, and a progressive 2x2 figure: the
+//! first (draft) frame, then the frames that refine one view each
+static void bench_progressive()
+{
+	const cv::Size SIZE = { 1280,720 };
+	for (auto type : { cvplot::chart::Line, cvplot::chart::Scatter })
+	{
+		cvplot::View view("progressive", SIZE);
+		view.AddSeries(cvplot::Series("s", type, cvplot::marker::Circle).AddValues(random_values(type, 2000000)));
+		std::string name = type == cvplot::chart::Line ? "progressive_line_2M" : "progressive_scatter_2M";
+		report(name + "_draft", render_ms(view, 3, cvplot::quality::Draft));
+		report(name + "_full", render_ms(view, 3));
+	}
+
+	cvplot::Figure figure(false);
+	figure.SetLayout(2, 2).SetSize({ 1280,720 }).EnableProgressive();
+	for (int r = 1; r <= 2; ++r)
+	{
+		for (int c = 1; c <= 2; ++c)
+		{
+			figure.SelectView(r, c).AddSeries(random_series("s", cvplot::chart::Line, 2000000));
+		}
+	}
+	figure.Refresh();
+	for (int r = 1; r <= 2; ++r)
+	{
+		for (int c = 1; c <= 2; ++c)
+		{
+			figure.SelectView(r, c).Invalidate();
+		}
+	}
+	auto start = std::chrono::steady_clock::now();
+	figure.Refresh();
+	report("progressive_figure_first_frame", elapsed_ms(start));
+	int frames = 0;
+	while (figure.IsRefining())
+	{
+		figure.Refresh();
+		++frames;
+	}
+	report("progressive_figure_refined", elapsed_ms(start));
+	std::cout << "refined in " << frames << " frames" << std::endl;
+	figure.Close();
+}
+
+//! best of runs "series" stage times (View profiling): Series::Draw of every series
+static double series_ms(cvplot::View& view, int runs)
+{
+	double best = DBL_MAX;
+	view.EnableProfiling(true);
+	for (int i = 0; i < runs; ++i)
+	{
+		view.Invalidate();
+		view.Render();
+		best = std::min(best, view.GetRenderStats().series);
+	}
+	view.EnableProfiling(false);
+	return best;
+}
+
+//! Series::Draw of 1M-sample Scatter (no marker, cross, circle) and Line (sorted,
+//! unsorted: x shuffled locally) series, the per sample projection and marker kernels
+static void bench_kernels()
+{
+	const cv::Size SIZE = { 1280,720 };
+	const char* markers[] = { "none", "cross", "plus", "star", "circle", "square", "diamond" };
+	auto points = random_values(cvplot::chart::Scatter, 1000000);
+	for (auto marker : { cvplot::marker::None, cvplot::marker::Cross, cvplot::marker::Circle })
+	{
+		cvplot::View view("scatter", SIZE);
+		view.AddSeries(cvplot::Series("s", cvplot::chart::Scatter, marker).AddValues(points));
+		report(std::string("kernel_scatter_1M_") + markers[marker], series_ms(view, 5));
+	}
+
+	auto sorted = random_values(cvplot::chart::Line, 1000000);
+	auto shuffled = sorted;
+	std::mt19937_64 rng(42);
+	for (size_t i = 0; i < shuffled.size() / 2; ++i)
+	{
+		//! x out of order within blocks of 8, the segments stay short
+		std::swap(shuffled[2 * i], shuffled[2 * (i - i % 8 + rng() % 8)]);
+	}
+	for (auto& line : { std::make_pair("sorted", &sorted), std::make_pair("unsorted", &shuffled) })
+	{
+		cvplot::View view("line", SIZE);
+		view.AddSeries(cvplot::Series("s", cvplot::chart::Line).AddValues(*line.second));
+		report(std::string("kernel_line_1M_") + line.first, series_ms(view, 5));
+	}
+}
+
+//! raster::Polylines against cv::polylines (LINE_AA) on a 1280x720 CV_8UC4 buffer: a
+//! decimated dense line (4 points per column), long random segments, thin and thick.
+//! also prints the largest and mean channel difference of the two outputs
+static void bench_raster()
+{
+	const cv::Size SIZE = { 1280,720 };
+	std::mt19937_64 rng(42);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	std::vector<cv::Point> dense;
+	double y = SIZE.height / 2.0;
+	for (int i = 0; i < 4 * SIZE.width; ++i)
+	{
+		y = std::max(0.0, std::min(SIZE.height - 1.0, y + 20 * dist(rng)));
+		dense.push_back({ i / 4, (int)y });
+	}
+	std::vector<cv::Point> random;
+	std::uniform_int_distribution<int> ux(0, SIZE.width - 1);
+	std::uniform_int_distribution<int> uy(0, SIZE.height - 1);
+	for (int i = 0; i < 100000; ++i)
+	{
+		random.push_back({ ux(rng),uy(rng) });
+	}
+
+	const int RUNS = 5;
+	cv::Scalar color(200, 80, 40, 255);
+	for (auto& scenario : { std::make_pair("dense_5k", &dense), std::make_pair("random_100k", &random) })
+	{
+		auto& pts = *scenario.second;
+		for (int thickness : { 1, 3 })
+		{
+			auto name = std::string("raster_") + scenario.first + "_th" + std::to_string(thickness);
+			cv::Mat reference(SIZE, CV_8UC4, cv::Scalar(255, 255, 255, 255));
+			cv::Mat mat(SIZE, CV_8UC4, cv::Scalar(255, 255, 255, 255));
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < RUNS; ++i)
+			{
+				cv::polylines(reference, pts, false, color, thickness, cv::LINE_AA);
+			}
+			report(name + "_cv", elapsed_ms(start) / RUNS);
+			start = std::chrono::steady_clock::now();
+			for (int i = 0; i < RUNS; ++i)
+			{
+				cvplot::raster::Polylines(mat, pts, color, thickness);
+			}
+			report(name, elapsed_ms(start) / RUNS);
+
+			reference.setTo(cv::Scalar(255, 255, 255, 255));
+			mat.setTo(cv::Scalar(255, 255, 255, 255));
+			cv::polylines(reference, pts, false, color, thickness, cv::LINE_AA);
+			cvplot::raster::Polylines(mat, pts, color, thickness);
+			cv::Mat diff;
+			cv::absdiff(reference, mat, diff);
+			double max_diff = 0;
+			cv::minMaxLoc(diff.reshape(1), nullptr, &max_diff);
+			auto mean = cv::mean(diff);
+			std::cout << name << " diff: max " << max_diff << " mean "
+				<< (mean[0] + mean[1] + mean[2] + mean[3]) / 4 << std::endl;
+		}
+	}
+}
+
+//! chart::Histogram ingest of 20M values (one AddValue each, one AddValues batch, fixed
+//! bins, a drifting stream that keeps the adaptive bins moving, through a live queue) and
+//! the render of the 64 bins. the memory stays at the bins whatever the count
+static void bench_histogram()
+{
+	const int N = 20000000;
+	std::mt19937_64 rng(42);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	std::vector<double> values(N);
+	for (auto& v : values)
+	{
+		v = dist(rng);
+	}
+
+	auto per_value = [&](const std::string& name, double ms)
+	{
+		report(name, ms);
+		std::cout << name << ": " << ms * 1e6 / N << " ns/value" << std::endl;
+	};
+
+	cvplot::Series adaptive("adaptive", cvplot::chart::Histogram);
+	auto start = std::chrono::steady_clock::now();
+	for (auto v : values)
+	{
+		adaptive.AddValue(v);
+	}
+	per_value("histogram_add_20M", elapsed_ms(start));
+
+	cvplot::Series batch("batch", cvplot::chart::Histogram);
+	auto batch_values = values;
+	start = std::chrono::steady_clock::now();
+	batch.AddValues(std::move(batch_values));
+	per_value("histogram_batch_20M", elapsed_ms(start));
+
+	cvplot::Series fixed("fixed", cvplot::chart::Histogram);
+	fixed.SetBins(-4, 4, 64);
+	auto fixed_values = values;
+	start = std::chrono::steady_clock::now();
+	fixed.AddValues(std::move(fixed_values));
+	per_value("histogram_fixed_20M", elapsed_ms(start));
+
+	cvplot::Series drift("drift", cvplot::chart::Histogram);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < N; ++i)
+	{
+		drift.AddValue(values[i] + i * 1e-4);
+	}
+	per_value("histogram_drift_20M", elapsed_ms(start));
+
+	const size_t BATCH = 1 << 16;
+	cvplot::Series live("live", cvplot::chart::Histogram);
+	live.SetLive(BATCH);
+	auto queue = live.GetLiveQueue();
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < values.size(); i += BATCH)
+	{
+		for (size_t j = i; j < std::min(values.size(), i + BATCH); ++j)
+		{
+			queue->Push(values[j]);
+		}
+		live.Drain();
+	}
+	per_value("histogram_live_20M", elapsed_ms(start));
+
+	cvplot::View view("histogram", { 1280,720 });
+	view.AddSeries(adaptive);
+	report("histogram_render", render_ms(view, 20));
+	std::cout << "histogram: " << adaptive.GetBins().GetCount() << " bins of " << adaptive.GetBins().GetWidth()
+		<< " over [" << adaptive.GetBins().GetLow() << ", " << adaptive.GetBins().GetHigh() << "), "
+		<< adaptive.GetMemory() << " bytes" << std::endl;
+
+	//! a reloaded histogram keeps its counts when values are added: into fresh bins
+	//! and into bins whose fixed layout doesn't match the loaded edges
+	adaptive.Dump("bench_hist");
+	adaptive.DumpBinary("bench_hist.bin");
+	auto peak = adaptive.CalcMax()[1];
+	for (int fixed_layout = 0; fixed_layout < 2; ++fixed_layout)
+	{
+		cvplot::Series reloaded("reloaded", cvplot::chart::Histogram);
+		if (fixed_layout)
+		{
+			reloaded.SetBins(0, 1, 64);
+		}
+		reloaded.Load("bench_hist");
+		reloaded.LoadBinary("bench_hist.bin", false);
+		reloaded.AddValue(values[0]);
+		auto& bins = reloaded.GetBins();
+		if (bins.GetCount() != adaptive.GetBins().GetCount() || bins.GetLow() != adaptive.GetBins().GetLow()
+			|| bins.GetWidth() != adaptive.GetBins().GetWidth() || reloaded.CalcMax()[1] < peak)
+		{
+			std::cout << "histogram: counts lost on reload" << std::endl;
+		}
+	}
+	std::remove("bench_hist");
+	std::remove("bench_hist.bin");
+}
+
+//! chart::Heatmap over a dense cv::Mat: the 1000x1000 grid of render_elevation_1000x1000
+//! (CV_64F) and a 2000x2000 one per depth, re-rendered after writing a row in place
+static void bench_heatmap()
+{
+	const cv::Size SIZE = { 1280,720 };
+	for (auto& grid : { std::make_pair(1000, CV_64F), std::make_pair(2000, CV_64F),
+		std::make_pair(2000, CV_32F), std::make_pair(2000, CV_16U), std::make_pair(2000, CV_8U) })
+	{
+		const int N = grid.first;
+		cv::Mat cells(N, N, CV_64F);
+		for (int i = 0; i < N; ++i)
+		{
+			auto row = cells.ptr<double>(i);
+			for (int j = 0; j < N; ++j)
+			{
+				row[j] = std::sin(i * 0.01) * std::cos(j * 0.01);
+			}
+		}
+		bool fp = grid.second == CV_32F || grid.second == CV_64F;
+		cv::Mat mat;
+		cells.convertTo(mat, grid.second, fp ? 1 : 100, fp ? 0 : 120);
+
+		const char* depths[] = { "8u", "8s", "16u", "16s", "32s", "32f", "64f" };
+		auto name = "render_heatmap_" + std::to_string(N) + "x" + std::to_string(N) + "_" + depths[grid.second];
+		cvplot::View view("heatmap", SIZE);
+		view.AddSeries(cvplot::Series("s", cvplot::chart::Heatmap).SetGrid(mat));
+		double best = DBL_MAX;
+		for (int run = 0; run < 5; ++run)
+		{
+			mat.row(run * N / 5).setTo(run);
+			best = std::min(best, render_ms(view, 1));
+		}
+		report(name, best);
+	}
+}
+
+static void write_csv(const std::string& filename)
+{
+	FILE* fp = cvplot::util::OpenFile(filename, "w");
+	if (fp == nullptr)
+	{
+		std::cout << "can't write " << filename << std::endl;
+		return;
+	}
+	fprintf(fp, "name,ms,mb_per_s\n");
+	for (auto& result : results__)
+	{
+		fprintf(fp, "%s,%.6f,%.6f\n", result.name.c_str(), result.ms, result.mbps);
+	}
+	fclose(fp);
+}
+
+static void write_json(const std::string& filename)
+{
+	FILE* fp = cvplot::util::OpenFile(filename, "w");
+	if (fp == nullptr)
+	{
+		std::cout << "can't write " << filename << std::endl;
+		return;
+	}
+	fprintf(fp, "{\n  \"results\": [\n");
+	for (size_t i = 0; i < results__.size(); ++i)
+	{
+		auto& result = results__[i];
+		fprintf(fp, "    { \"name\": \"%s\", \"ms\": %.6f, \"mb_per_s\": %.6f }%s\n",
+			result.name.c_str(), result.ms, result.mbps, i + 1 < results__.size() ? "," : "");
+	}
+	fprintf(fp, "  ]\n}\n");
+	fclose(fp);
+}
+
+//! usage: cvplot_bench [scenario] [--csv results.csv] [--json results.json]
+int main(int argc, char** argv)
+{
+	std::string filter;
+	std::string csv;
+	std::string json;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+		{
+			csv = argv[++i];
+		}
+		else if (arg == "--json" && i + 1 < argc)
+		{
+			json = argv[++i];
+		}
+		else
+		{
+			filter = arg;
+		}
+	}
+	struct
+	{
+		const char* name;
+		void(*run)();
+	} benches[] =
+	{
+		{ "render", bench_render },
+		{ "text", bench_text_codec },
+		{ "gorilla", bench_gorilla },
+		{ "figure", bench_figure_dump },
+		{ "metric", bench_metric },
+		{ "hover", bench_hover },
+		{ "zoom", bench_zoom },
+		{ "pyramid", bench_pyramid },
+		{ "profile", bench_profile },
+		{ "progressive", bench_progressive },
+		{ "raster", bench_raster },
+		{ "kernels", bench_kernels },
+		{ "histogram", bench_histogram },
+		{ "heatmap", bench_heatmap },
+	};
+
+	for (auto& bench : benches)
+	{
+		if (filter.empty() || filter == bench.name)
+		{
+			bench.run();
+		}
+	}
+
+	if (!csv.empty())
+	{
+		write_csv(csv);
+	}
+	if (!json.empty())
+	{
+		write_json(json);
+	}
+	return 0;
+}
@@ -1,15 +1,52 @@
 #ifndef CVPLOT_H
 #define CVPLOT_H
 
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <cerrno>
 #include <string>
+#include <sstream>
 #include <vector>
+#include <algorithm>
 #include <map>
+#include <set>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <limits>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
 #include <iomanip>
+#include <charconv>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/highgui/highgui.hpp>
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #ifndef byte
 typedef unsigned char byte;
 #endif
@@ -43,7 +80,9 @@ namespace cvplot
 			return *this;
 		}
 
-		Color& operator=(Color& rhs)
+		Color(const Color& rhs) = default;
+
+		Color& operator=(const Color& rhs)
 		{
 			if (this != &rhs)
 			{
@@ -55,12 +94,12 @@ namespace cvplot
 			return *this;
 		}
 
-		bool operator==(Color& rhs) const
+		bool operator==(const Color& rhs) const
 		{
 			return (r_ == rhs.r_ && g_ == rhs.g_ && b_ == rhs.b_ && a_ == rhs.a_);
 		}
 
-		bool operator!=(Color& rhs) const
+		bool operator!=(const Color& rhs) const
 		{
 			return (r_ != rhs.r_ || g_ != rhs.g_ || b_ != rhs.b_ || a_ != rhs.a_);
 		}
@@ -134,6 +173,8 @@ namespace cvplot
 		static const Type Line = 3;
 		static const Type Scatter = 4;
 		static const Type Elevation = 5;
+		static const Type Histogram = 6; //! bins of raw values, see Series::SetBins
+		static const Type Heatmap = 7;   //! a dense cv::Mat grid, see Series::SetGrid
 
 		static int GetDimension(Type type)
 		{
@@ -147,9 +188,11 @@ namespace cvplot
 				break;
 			case Line:
 			case Scatter:
+			case Histogram:
 				dim = 2;
 				break;
 			case Elevation:
+			case Heatmap:
 				dim = 3;
 				break;
 			default:
@@ -174,6 +217,16 @@ namespace cvplot
 		static const Type Diamond = 6;
 	}
 
+	namespace quality
+	{
+		typedef int Type;
+
+		//! LINE_8, decimated samples, no text: for the first frame of an interactive update
+		static const Type Draft = 1;
+		//! anti-aliased, every sample, labels
+		static const Type Full = 2;
+	}
+
 	namespace color
 	{
 		static const byte GAMMA_LUT[] =
@@ -285,717 +338,5635 @@ namespace cvplot
 			gw_mtx__.unlock();
 			return index;
 		}
-	}
-
-	class Series
-	{
-	public:
-		typedef double value_type;
 
-	private:
-		typedef std::vector<value_type> vector_type;
-
-	public:
-		Series(const std::string& label, chart::Type chartType, marker::Type markerType = marker::None)
-			: label_(label),
-			chart_type_(chartType),
-			marker_type_(markerType),
-			marker_size_({ 4,4 }),
-			dimension_(chart::GetDimension(chartType)),
-			enable_legend_(true),
-			render_color_(color::Blue),
-			dirty_(false)
+		//! run fn(0) .. fn(count - 1) on up to `threads` workers (0 for hardware concurrency),
+		//! the calling thread takes part. the first exception is rethrown once all have joined
+		template<typename F>
+		static void ParallelFor(size_t count, F fn, int threads = 0)
 		{
-			enable_legend_ = (chartType != chart::Elevation);
-		}
+			if (threads <= 0)
+			{
+				threads = std::max(1, (int)std::thread::hardware_concurrency());
+			}
+			threads = (int)std::min<size_t>(threads, count);
+			if (threads <= 1)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					fn(i);
+				}
+				return;
+			}
 
-		Series(Series& rhs, chart::Type chartType)
-			:label_(rhs.label_),
-			chart_type_(chartType),
-			marker_type_(rhs.marker_type_),
-			marker_size_(rhs.marker_size_),
-			enable_legend_(rhs.enable_legend_),
-			values_(std::move(rhs.values_)),
-			dimension_(chart::GetDimension(chartType)),
-			dirty_(true)
-		{
-			if (rhs.GetDimension() == 1 && dimension_ == 2)
+			std::atomic<size_t> next(0);
+			std::exception_ptr error;
+			std::mutex error_mtx;
+			auto work = [&]()
 			{
-				auto n = values_.size();
-				vector_type values(n * 2);
-				for (auto i = 0; i < n; ++i)
+				for (size_t i = next++; i < count; i = next++)
 				{
-					values[2 * i] = i + 1;
-					values[2 * i + 1] = values_[i];
+					try
+					{
+						fn(i);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(error_mtx);
+						if (!error)
+						{
+							error = std::current_exception();
+						}
+						next = count;
+					}
 				}
-				values_ = std::move(values);
+			};
+
+			std::vector<std::thread> workers;
+			for (int i = 1; i < threads; ++i)
+			{
+				workers.emplace_back(work);
 			}
-			else
+			work();
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+			if (error)
 			{
-				throw std::exception("invalid conversion (expect: dimension 1-->2)");
+				std::rethrow_exception(error);
 			}
 		}
 
-		Series() :Series("", chart::Bar)
+		//! replace target by source (best effort atomic)
+		static bool ReplaceFile(const std::string& source, const std::string& target)
 		{
-			//
+#ifdef _WIN32
+			return MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+			return rename(source.c_str(), target.c_str()) == 0;
+#endif
 		}
 
-		Series& operator=(Series& rhs)
+		//! fopen without the MSVC-only secure CRT
+		static FILE* OpenFile(const std::string& filename, const char* mode)
 		{
-			if (this != &rhs)
-			{
-				label_ = rhs.label_;
-				chart_type_ = rhs.chart_type_;
-				marker_type_ = rhs.marker_type_;
-				marker_size_ = rhs.marker_size_;
-				dimension_ = rhs.dimension_;
-				enable_legend_ = rhs.enable_legend_;
-				values_ = std::move(rhs.values_);
-				dirty_ = true;
-			}
-			return *this;
+			FILE* fp = nullptr;
+#ifdef _MSC_VER
+			fopen_s(&fp, filename.c_str(), mode);
+#else
+			fp = fopen(filename.c_str(), mode);
+#endif
+			return fp;
 		}
 
-		Series& SetChartType(chart::Type chartType)
+		//! fscanf_s on MSVC, fscanf elsewhere. numeric conversions only, strings are read
+		//! with ReadLine (fscanf has no bound for %s and %[ without a width)
+		template<typename... Args>
+		static int ScanFile(FILE* fp, const char* format, Args... args)
 		{
-			if (chart_type_ != chartType)
+#ifdef _MSC_VER
+			return fscanf_s(fp, format, args...);
+#else
+			return fscanf(fp, format, args...);
+#endif
+		}
+
+		//! the next line of any length, without its line break ("\n" or "\r\n").
+		//! false at the end of the file
+		static bool ReadLine(FILE* fp, std::string& line)
+		{
+			line.clear();
+			char buf[256];
+			while (fgets(buf, sizeof(buf), fp) != nullptr)
 			{
-				int dimension = chart::GetDimension(chartType);
-				if (dimension_ == dimension)
-				{
-					chart_type_ = chartType;
-					dirty_ = true;
-				}
-				else
+				line += buf;
+				if (line.back() == '\n')
 				{
-					if (values_.empty())
+					line.pop_back();
+					if (!line.empty() && line.back() == '\r')
 					{
-						chart_type_ = chartType;
-						dimension_ = dimension;
-						dirty_ = false;
-					}
-					else
-					{
-						throw std::exception("dimension not match for the chart type");
+						line.pop_back();
 					}
+					return true;
 				}
 			}
-			return *this;
-		}
-
-		Series& SetMarkerType(marker::Type markerType)
-		{
-			if (marker_type_ != markerType)
-			{
-				marker_type_ = markerType;
-				dirty_ = true;
-			}
-			return *this;
+			return !line.empty();
 		}
 
-		Series& SetMarkerSize(cv::Size size)
+		static int Seek64(FILE* fp, uint64_t offset)
 		{
-			if (marker_size_ != size)
-			{
-				marker_size_ = size;
-				dirty_ = true;
-			}
-			return *this;
+#ifdef _WIN32
+			return _fseeki64(fp, (__int64)offset, SEEK_SET);
+#else
+			return fseeko(fp, (off_t)offset, SEEK_SET);
+#endif
 		}
 
-		Series& EnableLegend(bool enable)
+		//! true if another Mat header (a frame handed out, a copy) refers to the pixels
+		static bool IsShared(const cv::Mat& mat)
 		{
-			if (enable_legend_ != enable)
-			{
-				enable_legend_ = enable;
-				dirty_ = true;
-			}
-			return *this;
+			return mat.u != nullptr && mat.u->refcount > 1;
 		}
 
-		Series& SetRenderColor(Color color)
+		//! bytes of the pixels, 0 if counted before (frames shared between views and figure)
+		static size_t FrameBytes(const cv::Mat& mat, std::set<const void*>& counted)
 		{
-			if (render_color_ != color)
+			if (mat.empty() || !counted.insert(mat.u ? (const void*)mat.u : (const void*)mat.data).second)
 			{
-				render_color_ = color;
-				dirty_ = true;
+				return 0;
 			}
-			return *this;
+			return mat.step[0] * mat.rows;
 		}
 
-		Series& AddValue(value_type value)
+		//! read-only mapping of a whole file
+		class MappedFile
 		{
-			if (dimension_ != 1)
+		public:
+			MappedFile() : data_(nullptr), size_(0)
 			{
-				return *this;
+				//
 			}
 
-			values_.push_back(value);
-			dirty_ = true;
-			return *this;
-		}
-
-		Series& AddValues(vector_type values)
-		{
-			if (dimension_ < 1)
+			MappedFile(const std::string& filename) : MappedFile()
 			{
-				return *this;
+				Open(filename);
 			}
 
-			auto count = (values.size() / dimension_) * dimension_;
-			for (int i = 0; i < count; ++i)
+			~MappedFile()
 			{
-				values_.push_back(values[i]);
+				Close();
 			}
 
-			if (count > 0)
-			{
-				dirty_ = true;
-			}
-			return *this;
-		}
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
 
-		Series& AppendArray(vector_type values)
-		{
-			if (dimension_ != 2)
+			void Open(const std::string& filename)
 			{
-				return *this;
+				Close();
+#ifdef _WIN32
+				HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+					OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (file == INVALID_HANDLE_VALUE)
+				{
+					throw std::runtime_error("failed to open file");
+				}
+				LARGE_INTEGER size;
+				if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+				{
+					HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (mapping != nullptr)
+					{
+						data_ = (const byte*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+						CloseHandle(mapping);
+					}
+					size_ = (size_t)size.QuadPart;
+				}
+				CloseHandle(file);
+#else
+				int fd = open(filename.c_str(), O_RDONLY);
+				if (fd < 0)
+				{
+					throw std::runtime_error("failed to open file");
+				}
+				struct stat st;
+				if (fstat(fd, &st) == 0 && st.st_size > 0)
+				{
+					size_ = (size_t)st.st_size;
+					void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+					data_ = (p == MAP_FAILED) ? nullptr : (const byte*)p;
+				}
+				close(fd);
+#endif
+				if (data_ == nullptr && size_ > 0)
+				{
+					size_ = 0;
+					throw std::runtime_error("failed to map file");
+				}
 			}
 
-			auto idx = values_.size();
-			if (!values_.empty())
-			{
-				idx = values_[idx - 2];
-			}
-			auto count = values.size();
-			for (int i = 0; i < count; ++i)
+			void Close()
 			{
-				values_.push_back(++idx);
-				values_.push_back(values[i]);
+				if (data_)
+				{
+#ifdef _WIN32
+					UnmapViewOfFile(data_);
+#else
+					munmap((void*)data_, size_);
+#endif
+				}
+				data_ = nullptr;
+				size_ = 0;
 			}
 
-			if (idx > 0)
+			const byte* GetData() const
 			{
-				dirty_ = true;
+				return data_;
 			}
-			return *this;
-		}
 
-		Series& Clear()
-		{
-			if (!values_.empty())
+			size_t GetSize() const
 			{
-				values_.clear();
-				dirty_ = true;
+				return size_;
 			}
 
-			return *this;
-		}
-
-		int GetDimension() const
-		{
-			return dimension_;
-		}
+		private:
+			const byte* data_;
+			size_t size_;
+		};
+	}
 
-		int GetSampleCount() const
-		{
-			return values_.size() / dimension_;
-		}
+	namespace text
+	{
+		static const size_t BLOCK_SIZE = 1 << 20;
 
-		std::string GetLabel() const
+		//! buffered writer, numbers are formatted with the shortest text that round-trips
+		class Writer
 		{
-			return label_;
-		}
+		public:
+			Writer(FILE* fp) : fp_(fp), buffer_(BLOCK_SIZE), pos_(0)
+			{
+				//
+			}
 
-		chart::Type GetChartType() const
-		{
-			return chart_type_;
-		}
+			~Writer()
+			{
+				Flush();
+			}
 
-		marker::Type GetMarkerType() const
-		{
-			return marker_type_;
-		}
+			Writer(const Writer&) = delete;
+			Writer& operator=(const Writer&) = delete;
 
-		cv::Size GetMarkerSize() const
-		{
-			return marker_size_;
-		}
+			Writer& Put(double v)
+			{
+				if (pos_ + 32 > buffer_.size())
+				{
+					Flush();
+				}
+				auto result = std::to_chars(buffer_.data() + pos_, buffer_.data() + buffer_.size(), v);
+				pos_ = result.ptr - buffer_.data();
+				return *this;
+			}
 
-		bool IsLegendEnabled() const
-		{
-			return enable_legend_;
-		}
+			Writer& Put(char c)
+			{
+				if (pos_ == buffer_.size())
+				{
+					Flush();
+				}
+				buffer_[pos_++] = c;
+				return *this;
+			}
 
-		Color GetRenderColor() const
-		{
-			return render_color_;
-		}
+			void Flush()
+			{
+				if (pos_ > 0)
+				{
+					fwrite(buffer_.data(), 1, pos_, fp_);
+					pos_ = 0;
+				}
+			}
 
-		bool IsDirty() const
-		{
-			return dirty_;
-		}
+		private:
+			FILE* fp_;
+			std::vector<char> buffer_;
+			size_t pos_;
+		};
 
-		vector_type CalcMax() const
+		//! buffered reader for whitespace separated numbers
+		class Reader
 		{
-			auto count = values_.size();
-			if (count < dimension_)
+		public:
+			Reader(FILE* fp) : fp_(fp), buffer_(BLOCK_SIZE), begin_(0), end_(0), eof_(false)
 			{
-				return vector_type(dimension_, 0.0);
+				//
 			}
 
-			vector_type maxs(dimension_);
-			for (auto j = 0; j < dimension_; ++j)
+			Reader(const Reader&) = delete;
+			Reader& operator=(const Reader&) = delete;
+
+			//! false at the end of the input or on a malformed number
+			bool Next(double& v)
 			{
-				maxs[j] = values_[j];
-				for (auto i = 0; i < count; i += dimension_)
+				for (;;)
 				{
-					if (values_[i + j] > maxs[j])
+					while (begin_ < end_ && IsSpace_(buffer_[begin_]))
 					{
-						maxs[j] = values_[i + j];
+						++begin_;
 					}
-				}
-			}
+
+					//! make sure the token is complete before parsing it
+					auto token_end = begin_;
+					while (token_end < end_ && !IsSpace_(buffer_[token_end]))
+					{
+						++token_end;
+					}
+					if (token_end == end_ && !eof_)
+					{
+						Refill_();
+						continue;
+					}
+					if (begin_ == end_)
+					{
+						return false;
+					}
+
+					auto first = buffer_.data() + begin_;
+					if (*first == '+')
+					{
+						++first;
+					}
+					//! the whole token must be the number, out of range values are malformed too
+					double parsed;
+					auto result = std::from_chars(first, buffer_.data() + token_end, parsed);
+					if (result.ec != std::errc() || result.ptr != buffer_.data() + token_end)
+					{
+						return false;
+					}
+					v = parsed;
+					begin_ = token_end;
+					return true;
+				}
+			}
+
+		private:
+			static bool IsSpace_(char c)
+			{
+				return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+			}
+
+			void Refill_()
+			{
+				//! keep the partial token, grow the buffer if a single token fills it
+				auto remaining = end_ - begin_;
+				if (begin_ > 0)
+				{
+					memmove(buffer_.data(), buffer_.data() + begin_, remaining);
+				}
+				else if (remaining == buffer_.size())
+				{
+					buffer_.resize(buffer_.size() * 2);
+				}
+				begin_ = 0;
+				end_ = remaining;
+				auto n = fread(buffer_.data() + end_, 1, buffer_.size() - end_, fp_);
+				end_ += n;
+				eof_ = (n == 0);
+			}
+
+		private:
+			FILE* fp_;
+			std::vector<char> buffer_;
+			size_t begin_;
+			size_t end_;
+			bool eof_;
+		};
+	}
+
+	namespace dump
+	{
+		typedef int Encoding;
+
+		static const Encoding Raw = 0;     //! .sdp.txt + .sdp.bin
+		static const Encoding Gorilla = 1; //! .sdp.gor, see cvplot::gorilla
+	}
+
+	namespace gorilla
+	{
+		//! Gorilla-style compression of interleaved series values, column by column:
+		//! columns that are exact integers or exact decimals (evenly spaced x, counters,
+		//! 0.1 steps) use delta-of-delta coding of the scaled integers, other columns
+		//! XOR each value with its predecessor and only store the meaningful bits.
+		//! every column decodes bit for bit, -0.0 and NaN payloads included. layout:
+		//!   magic | version u16 | dimension u16 | samples u64 | per column: mode u8, bits u64, words
+		static const char MAGIC[4] = { 'C', 'V', 'G', 'Z' };
+		static const uint16_t VERSION = 1;
+		static const uint16_t VERSION_DECIMAL = 2; //! written only if a decimal column is present
+
+		static const byte XOR = 0;
+		static const byte DELTA_OF_DELTA = 1;
+		//! DECIMAL | k: integers n decoded as n / 10^k, DECIMAL_STEP | k: as n * 1e-k
+		//! (what x = i / 10.0 and x = i * 0.1 produce respectively)
+		static const byte DECIMAL = 0x10;
+		static const byte DECIMAL_STEP = 0x20;
+		static const int MAX_DECIMALS = 6;
+
+		class BitWriter
+		{
+		public:
+			BitWriter() : bits_(0)
+			{
+				//
+			}
+
+			void Write(uint64_t value, int count)
+			{
+				if (count == 0)
+				{
+					return;
+				}
+				if (count < 64)
+				{
+					value &= (1ULL << count) - 1;
+				}
+				auto used = (int)(bits_ & 63);
+				if (used == 0)
+				{
+					words_.push_back(0);
+				}
+				auto room = 64 - used;
+				if (count <= room)
+				{
+					words_.back() |= value << (room - count);
+				}
+				else
+				{
+					words_.back() |= value >> (count - room);
+					words_.push_back(value << (64 - (count - room)));
+				}
+				bits_ += count;
+			}
+
+			const std::vector<uint64_t>& GetWords() const
+			{
+				return words_;
+			}
+
+			uint64_t GetBitCount() const
+			{
+				return bits_;
+			}
+
+		private:
+			std::vector<uint64_t> words_;
+			uint64_t bits_;
+		};
+
+		class BitReader
+		{
+		public:
+			BitReader(const uint64_t* words, uint64_t bits) : words_(words), bits_(bits), pos_(0)
+			{
+				//
+			}
+
+			uint64_t Read(int count)
+			{
+				if (count == 0)
+				{
+					return 0;
+				}
+				if (pos_ + count > bits_)
+				{
+					throw std::runtime_error("truncated gorilla stream");
+				}
+				auto index = pos_ >> 6;
+				auto used = (int)(pos_ & 63);
+				auto room = 64 - used;
+				uint64_t value;
+				if (count <= room)
+				{
+					value = (words_[index] << used) >> (64 - count);
+				}
+				else
+				{
+					value = ((words_[index] << used) >> (64 - count)) | (words_[index + 1] >> (64 - (count - room)));
+				}
+				pos_ += count;
+				return value;
+			}
+
+			bool ReadBit()
+			{
+				return Read(1) != 0;
+			}
+
+		private:
+			const uint64_t* words_;
+			uint64_t bits_;
+			uint64_t pos_;
+		};
+
+		static uint64_t ToBits(double v)
+		{
+			uint64_t u;
+			memcpy(&u, &v, sizeof(u));
+			return u;
+		}
+
+		static double FromBits(uint64_t u)
+		{
+			double v;
+			memcpy(&v, &u, sizeof(v));
+			return v;
+		}
+
+		//! v must not be 0
+		static int LeadingZeros(uint64_t v)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanReverse64(&index, v);
+			return 63 - (int)index;
+#else
+			return __builtin_clzll(v);
+#endif
+		}
+
+		//! v must not be 0
+		static int TrailingZeros(uint64_t v)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward64(&index, v);
+			return (int)index;
+#else
+			return __builtin_ctzll(v);
+#endif
+		}
+
+		//! scale applied before rounding to integers, and whether decoding divides by it
+		//! (DELTA_OF_DELTA, DECIMAL) or multiplies by its inverse (DECIMAL_STEP)
+		static double Scale(byte mode, bool& divide)
+		{
+			static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+			static const double STEP10[] = { 1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6 };
+			auto k = mode & 0x0F;
+			if (mode == XOR || k > MAX_DECIMALS || (mode != DELTA_OF_DELTA && mode != (DECIMAL | k) && mode != (DECIMAL_STEP | k)))
+			{
+				throw std::runtime_error("invalid gorilla stream");
+			}
+			divide = (mode & DECIMAL_STEP) == 0;
+			return divide ? POW10[mode == DELTA_OF_DELTA ? 0 : k] : STEP10[k];
+		}
+
+		static double Unscale(int64_t n, double scale, bool divide)
+		{
+			if (scale == 1.0)
+			{
+				return (double)n; //! plain integers, no division in the hot loop
+			}
+			return divide ? (double)n / scale : (double)n * scale;
+		}
+
+		//! the first delta-of-delta mode that reproduces every value of the column
+		//! bit for bit (so -0.0 and NaN fall back to XOR), XOR if none does
+		static byte ChooseMode(const double* data, size_t samples, int dimension, int column)
+		{
+			const double LIMIT = 4503599627370496.0; //! 2^52, deltas stay exact below it
+			for (int k = 0; k <= MAX_DECIMALS; ++k)
+			{
+				for (int step = 0; step < (k == 0 ? 1 : 2); ++step)
+				{
+					byte mode = k == 0 ? DELTA_OF_DELTA : (byte)((step ? DECIMAL_STEP : DECIMAL) | k);
+					bool divide;
+					auto scale = Scale(mode, divide);
+					auto factor = divide ? scale : 1.0 / scale;
+					size_t i = 0;
+					for (; i < samples; ++i)
+					{
+						auto v = data[i * dimension + column];
+						auto n = factor == 1.0 ? v : std::round(v * factor);
+						if (!(n > -LIMIT && n < LIMIT) || ToBits(Unscale((int64_t)n, scale, divide)) != ToBits(v))
+						{
+							break;
+						}
+					}
+					if (i == samples)
+					{
+						return mode;
+					}
+				}
+			}
+			return XOR;
+		}
+
+		static void EncodeDeltaOfDelta(BitWriter& writer, const double* data, size_t samples, int dimension, int column, byte mode)
+		{
+			bool divide;
+			auto scale = Scale(mode, divide);
+			auto factor = divide ? scale : 1.0 / scale;
+			int64_t prev = 0;
+			int64_t prev_delta = 0;
+			for (size_t i = 0; i < samples; ++i)
+			{
+				auto x = data[i * dimension + column];
+				auto v = (int64_t)(factor == 1.0 ? x : std::round(x * factor));
+				if (i == 0)
+				{
+					writer.Write((uint64_t)v, 64);
+				}
+				else
+				{
+					auto delta = v - prev;
+					auto dod = delta - prev_delta;
+					if (dod == 0)
+					{
+						writer.Write(0, 1);
+					}
+					else if (dod >= -63 && dod <= 64)
+					{
+						writer.Write(0x2, 2);
+						writer.Write((uint64_t)(dod + 63), 7);
+					}
+					else if (dod >= -255 && dod <= 256)
+					{
+						writer.Write(0x6, 3);
+						writer.Write((uint64_t)(dod + 255), 9);
+					}
+					else if (dod >= -2047 && dod <= 2048)
+					{
+						writer.Write(0xE, 4);
+						writer.Write((uint64_t)(dod + 2047), 12);
+					}
+					else
+					{
+						writer.Write(0xF, 4);
+						writer.Write((uint64_t)dod, 64);
+					}
+					prev_delta = delta;
+				}
+				prev = v;
+			}
+		}
+
+		static void DecodeDeltaOfDelta(BitReader& reader, double* data, size_t samples, int dimension, int column, byte mode)
+		{
+			bool divide;
+			auto scale = Scale(mode, divide);
+			int64_t prev = 0;
+			int64_t prev_delta = 0;
+			for (size_t i = 0; i < samples; ++i)
+			{
+				int64_t v;
+				if (i == 0)
+				{
+					v = (int64_t)reader.Read(64);
+				}
+				else
+				{
+					int64_t dod;
+					if (!reader.ReadBit())
+					{
+						dod = 0;
+					}
+					else if (!reader.ReadBit())
+					{
+						dod = (int64_t)reader.Read(7) - 63;
+					}
+					else if (!reader.ReadBit())
+					{
+						dod = (int64_t)reader.Read(9) - 255;
+					}
+					else if (!reader.ReadBit())
+					{
+						dod = (int64_t)reader.Read(12) - 2047;
+					}
+					else
+					{
+						dod = (int64_t)reader.Read(64);
+					}
+					prev_delta += dod;
+					v = prev + prev_delta;
+				}
+				data[i * dimension + column] = Unscale(v, scale, divide);
+				prev = v;
+			}
+		}
+
+		static void EncodeXor(BitWriter& writer, const double* data, size_t samples, int dimension, int column)
+		{
+			uint64_t prev = 0;
+			int prev_leading = 65;
+			int prev_trailing = 0;
+			for (size_t i = 0; i < samples; ++i)
+			{
+				auto v = ToBits(data[i * dimension + column]);
+				if (i == 0)
+				{
+					writer.Write(v, 64);
+				}
+				else
+				{
+					auto x = v ^ prev;
+					if (x == 0)
+					{
+						writer.Write(0, 1);
+					}
+					else
+					{
+						auto leading = std::min(LeadingZeros(x), 31);
+						auto trailing = TrailingZeros(x);
+						if (prev_leading <= leading && prev_trailing <= trailing)
+						{
+							//! the meaningful bits fit in the previous window
+							writer.Write(0x2, 2);
+							writer.Write(x >> prev_trailing, 64 - prev_leading - prev_trailing);
+						}
+						else
+						{
+							auto length = 64 - leading - trailing;
+							writer.Write(0x3, 2);
+							writer.Write(leading, 5);
+							writer.Write(length - 1, 6);
+							writer.Write(x >> trailing, length);
+							prev_leading = leading;
+							prev_trailing = trailing;
+						}
+					}
+				}
+				prev = v;
+			}
+		}
+
+		static void DecodeXor(BitReader& reader, double* data, size_t samples, int dimension, int column)
+		{
+			uint64_t prev = 0;
+			int leading = 0;
+			int trailing = 0;
+			for (size_t i = 0; i < samples; ++i)
+			{
+				uint64_t v;
+				if (i == 0)
+				{
+					v = reader.Read(64);
+				}
+				else if (!reader.ReadBit())
+				{
+					v = prev;
+				}
+				else
+				{
+					if (reader.ReadBit())
+					{
+						leading = (int)reader.Read(5);
+						auto length = (int)reader.Read(6) + 1;
+						trailing = 64 - leading - length;
+					}
+					v = prev ^ (reader.Read(64 - leading - trailing) << trailing);
+				}
+				data[i * dimension + column] = FromBits(v);
+				prev = v;
+			}
+		}
+
+		static std::vector<byte> Encode(const double* data, size_t samples, int dimension)
+		{
+			std::vector<byte> out(sizeof(MAGIC) + 2 * sizeof(uint16_t) + sizeof(uint64_t));
+			uint16_t version = VERSION;
+			uint16_t dim = (uint16_t)dimension;
+			uint64_t count = samples;
+			memcpy(out.data(), MAGIC, sizeof(MAGIC));
+			memcpy(out.data() + 6, &dim, 2);
+			memcpy(out.data() + 8, &count, 8);
+
+			for (int j = 0; j < dimension; ++j)
+			{
+				BitWriter writer;
+				byte mode = ChooseMode(data, samples, dimension, j);
+				if (mode != XOR)
+				{
+					EncodeDeltaOfDelta(writer, data, samples, dimension, j, mode);
+					if (mode != DELTA_OF_DELTA)
+					{
+						version = VERSION_DECIMAL;
+					}
+				}
+				else
+				{
+					EncodeXor(writer, data, samples, dimension, j);
+				}
+				auto bits = writer.GetBitCount();
+				auto& words = writer.GetWords();
+				auto pos = out.size();
+				out.resize(pos + 1 + sizeof(bits) + words.size() * sizeof(uint64_t));
+				out[pos] = mode;
+				memcpy(out.data() + pos + 1, &bits, sizeof(bits));
+				if (!words.empty())
+				{
+					memcpy(out.data() + pos + 1 + sizeof(bits), words.data(), words.size() * sizeof(uint64_t));
+				}
+			}
+			memcpy(out.data() + 4, &version, 2);
+			return out;
+		}
+
+		//! decode into values (samples * dimension doubles), returns the dimension
+		static int Decode(const byte* data, size_t size, std::vector<double>& values)
+		{
+			const size_t HEADER = 16;
+			if (size < HEADER || memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+			{
+				throw std::runtime_error("invalid gorilla stream");
+			}
+			uint16_t version;
+			uint16_t dimension;
+			uint64_t samples;
+			memcpy(&version, data + 4, 2);
+			memcpy(&dimension, data + 6, 2);
+			memcpy(&samples, data + 8, 8);
+			//! every sample takes at least one bit per column, which bounds the count
+			//! before anything is allocated for it
+			if ((version != VERSION && version != VERSION_DECIMAL) || dimension == 0 || samples > (uint64_t)(size - HEADER) * 8 / dimension)
+			{
+				throw std::runtime_error("invalid gorilla stream");
+			}
+
+			values.resize((size_t)samples * dimension);
+			size_t pos = HEADER;
+			std::vector<uint64_t> words;
+			for (int j = 0; j < dimension; ++j)
+			{
+				uint64_t bits;
+				if (pos + 1 + sizeof(bits) > size)
+				{
+					throw std::runtime_error("truncated gorilla stream");
+				}
+				auto mode = data[pos];
+				memcpy(&bits, data + pos + 1, sizeof(bits));
+				pos += 1 + sizeof(bits);
+				auto n = (size_t)((bits + 63) / 64);
+				if (pos + n * sizeof(uint64_t) > size)
+				{
+					throw std::runtime_error("truncated gorilla stream");
+				}
+				words.resize(n + 1);
+				memcpy(words.data(), data + pos, n * sizeof(uint64_t));
+				words[n] = 0;
+				pos += n * sizeof(uint64_t);
+
+				BitReader reader(words.data(), bits);
+				if (mode != XOR)
+				{
+					DecodeDeltaOfDelta(reader, values.data(), (size_t)samples, dimension, j, mode);
+				}
+				else
+				{
+					DecodeXor(reader, values.data(), (size_t)samples, dimension, j);
+				}
+			}
+			return dimension;
+		}
+	}
+
+	namespace shm
+	{
+		//! shared memory layout (all offsets are relative to the start of the region):
+		//!   RingHeader | SlotHeader x slot_count | slot 0 pixels | slot 1 pixels | ...
+		//! each slot is guarded by its own seqlock, the sequence is odd while the
+		//! publisher is writing and even once the frame is complete
+		static const uint32_t MAGIC = 0x48535643; // "CVSH"
+		static const uint32_t VERSION = 1;
+		static const size_t ALIGNMENT = 64;
+
+		struct alignas(64) RingHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			int32_t rows;
+			int32_t cols;
+			int32_t type;
+			uint32_t slot_count;
+			uint64_t slot_stride;
+			uint64_t data_offset;
+			std::atomic<uint64_t> frame; //! number of the latest complete frame, 0 if none
+		};
+
+		struct alignas(64) SlotHeader
+		{
+			std::atomic<uint64_t> seq;
+			uint64_t frame;
+			int64_t timestamp; //! microseconds since epoch
+		};
+
+		static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory ring requires lock-free 64-bit atomics");
+
+		static size_t AlignUp(size_t n)
+		{
+			return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		}
+
+		class Region
+		{
+		public:
+			Region() : data_(nullptr), size_(0), owner_(false)
+#ifdef _WIN32
+				, handle_(nullptr)
+#endif
+			{
+				//
+			}
+
+			~Region()
+			{
+				Close();
+			}
+
+			Region(const Region&) = delete;
+			Region& operator=(const Region&) = delete;
+
+			void Create(const std::string& name, size_t size)
+			{
+				Close();
+				name_ = Normalize_(name);
+#ifdef _WIN32
+				handle_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+					(DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xFFFFFFFF), name_.c_str());
+				if (handle_ == nullptr)
+				{
+					throw std::runtime_error("failed to create shared memory");
+				}
+				if (GetLastError() == ERROR_ALREADY_EXISTS)
+				{
+					Close();
+					throw std::runtime_error("shared memory already exists: " + name_);
+				}
+				data_ = MapViewOfFile(handle_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#else
+				int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+				if (fd < 0)
+				{
+					if (errno == EEXIST)
+					{
+						throw std::runtime_error("shared memory already exists: " + name_);
+					}
+					throw std::runtime_error("failed to create shared memory");
+				}
+				if (ftruncate(fd, (off_t)size) != 0)
+				{
+					close(fd);
+					shm_unlink(name_.c_str());
+					throw std::runtime_error("failed to resize shared memory");
+				}
+				data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				close(fd);
+				if (data_ == MAP_FAILED)
+				{
+					data_ = nullptr;
+				}
+#endif
+				if (data_ == nullptr)
+				{
+					Close();
+					throw std::runtime_error("failed to map shared memory");
+				}
+				size_ = size;
+				owner_ = true;
+			}
+
+			void Open(const std::string& name)
+			{
+				Close();
+				name_ = Normalize_(name);
+#ifdef _WIN32
+				handle_ = OpenFileMappingA(FILE_MAP_READ, FALSE, name_.c_str());
+				if (handle_ == nullptr)
+				{
+					throw std::runtime_error("failed to open shared memory");
+				}
+				data_ = MapViewOfFile(handle_, FILE_MAP_READ, 0, 0, 0);
+				if (data_ != nullptr)
+				{
+					MEMORY_BASIC_INFORMATION info;
+					VirtualQuery(data_, &info, sizeof(info));
+					size_ = info.RegionSize;
+				}
+#else
+				int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+				if (fd < 0)
+				{
+					throw std::runtime_error("failed to open shared memory");
+				}
+				struct stat st;
+				if (fstat(fd, &st) == 0 && st.st_size > 0)
+				{
+					size_ = (size_t)st.st_size;
+					data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+					if (data_ == MAP_FAILED)
+					{
+						data_ = nullptr;
+					}
+				}
+				close(fd);
+#endif
+				if (data_ == nullptr)
+				{
+					Close();
+					throw std::runtime_error("failed to map shared memory");
+				}
+				owner_ = false;
+			}
+
+			//! remove a region left behind by a publisher that did not exit cleanly,
+			//! Create refuses to take over a name that is still in use
+			static void Remove(const std::string& name)
+			{
+#ifndef _WIN32
+				shm_unlink(Normalize_(name).c_str());
+#else
+				(void)name;
+#endif
+			}
+
+			void Close()
+			{
+#ifdef _WIN32
+				if (data_)
+				{
+					UnmapViewOfFile(data_);
+				}
+				if (handle_)
+				{
+					CloseHandle(handle_);
+					handle_ = nullptr;
+				}
+#else
+				if (data_)
+				{
+					munmap(data_, size_);
+				}
+				if (owner_)
+				{
+					shm_unlink(name_.c_str());
+				}
+#endif
+				data_ = nullptr;
+				size_ = 0;
+				owner_ = false;
+			}
+
+			void* GetData() const
+			{
+				return data_;
+			}
+
+			size_t GetSize() const
+			{
+				return size_;
+			}
+
+		private:
+			static std::string Normalize_(const std::string& name)
+			{
+#ifdef _WIN32
+				return (!name.empty() && name[0] == '/') ? name.substr(1) : name;
+#else
+				return (!name.empty() && name[0] == '/') ? name : "/" + name;
+#endif
+			}
+
+		private:
+			std::string name_;
+			void* data_;
+			size_t size_;
+			bool owner_;
+#ifdef _WIN32
+			HANDLE handle_;
+#endif
+		};
+
+		//! a frame handed out by Reader, the image refers to the shared pages directly
+		struct Frame
+		{
+			cv::Mat image;
+			uint64_t number = 0;
+			uint64_t seq = 0;
+			int64_t timestamp = 0;
+			uint32_t slot = 0;
+		};
+
+		class Publisher
+		{
+		public:
+			Publisher(const std::string& name, cv::Size size, int slots = 3)
+				: frame_(0)
+			{
+				if (size.width <= 0 || size.height <= 0 || slots < 2)
+				{
+					throw std::invalid_argument("invalid shared memory ring geometry");
+				}
+
+				size_t stride = AlignUp((size_t)size.width * size.height * 4);
+				size_t data_offset = AlignUp(sizeof(RingHeader) + slots * sizeof(SlotHeader));
+				region_.Create(name, data_offset + stride * slots);
+
+				header_ = new (region_.GetData()) RingHeader();
+				header_->magic = MAGIC;
+				header_->version = VERSION;
+				header_->rows = size.height;
+				header_->cols = size.width;
+				header_->type = CV_8UC4;
+				header_->slot_count = slots;
+				header_->slot_stride = stride;
+				header_->data_offset = data_offset;
+				slots_ = new (header_ + 1) SlotHeader[slots]();
+				header_->frame.store(0, std::memory_order_release);
+			}
+
+			Publisher(const Publisher&) = delete;
+			Publisher& operator=(const Publisher&) = delete;
+
+			//! copy the frame into the next slot of the ring, returns the frame number
+			uint64_t Publish(const cv::Mat& frame)
+			{
+				if (frame.type() != CV_8UC4 || frame.rows != header_->rows || frame.cols != header_->cols)
+				{
+					throw std::invalid_argument("frame does not match the shared memory ring");
+				}
+
+				auto number = ++frame_;
+				auto index = (uint32_t)((number - 1) % header_->slot_count);
+				auto& slot = slots_[index];
+				auto seq = slot.seq.load(std::memory_order_relaxed);
+				slot.seq.store(seq + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+
+				cv::Mat target(header_->rows, header_->cols, CV_8UC4, SlotData_(index));
+				frame.copyTo(target);
+				slot.frame = number;
+				slot.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::system_clock::now().time_since_epoch()).count();
+
+				slot.seq.store(seq + 2, std::memory_order_release);
+				header_->frame.store(number, std::memory_order_release);
+				return number;
+			}
+
+			uint64_t GetFrameCount() const
+			{
+				return frame_;
+			}
+
+		private:
+			byte* SlotData_(uint32_t index) const
+			{
+				return (byte*)region_.GetData() + header_->data_offset + index * header_->slot_stride;
+			}
+
+		private:
+			Region region_;
+			RingHeader* header_;
+			SlotHeader* slots_;
+			uint64_t frame_;
+		};
+
+		class Reader
+		{
+		public:
+			Reader(const std::string& name)
+			{
+				region_.Open(name);
+				header_ = reinterpret_cast<const RingHeader*>(region_.GetData());
+				if (region_.GetSize() < sizeof(RingHeader) || header_->magic != MAGIC || header_->version != VERSION
+					|| header_->slot_count == 0 || header_->rows <= 0 || header_->cols <= 0 || header_->type != CV_8UC4
+					|| header_->slot_stride < (uint64_t)header_->rows * header_->cols * 4
+					|| header_->data_offset < sizeof(RingHeader) + (uint64_t)header_->slot_count * sizeof(SlotHeader)
+					|| header_->data_offset > region_.GetSize()
+					|| (region_.GetSize() - header_->data_offset) / header_->slot_stride < header_->slot_count)
+				{
+					throw std::runtime_error("invalid shared memory ring");
+				}
+				slots_ = reinterpret_cast<const SlotHeader*>(header_ + 1);
+			}
+
+			Reader(const Reader&) = delete;
+			Reader& operator=(const Reader&) = delete;
+
+			//! map the latest complete frame without copying, returns false if there
+			//! is no frame yet or if it is being overwritten right now (just retry).
+			//! the pixels stay valid as long as IsValid(frame) keeps returning true
+			bool Latest(Frame& frame) const
+			{
+				auto number = header_->frame.load(std::memory_order_acquire);
+				if (number == 0)
+				{
+					return false;
+				}
+
+				auto index = (uint32_t)((number - 1) % header_->slot_count);
+				auto& slot = slots_[index];
+				auto seq = slot.seq.load(std::memory_order_acquire);
+				if ((seq & 1) != 0 || slot.frame != number)
+				{
+					return false;
+				}
+
+				frame.image = cv::Mat(header_->rows, header_->cols, header_->type,
+					(void*)((const byte*)region_.GetData() + header_->data_offset + index * header_->slot_stride));
+				frame.number = number;
+				frame.seq = seq;
+				frame.timestamp = slot.timestamp;
+				frame.slot = index;
+				std::atomic_thread_fence(std::memory_order_acquire);
+				return slot.seq.load(std::memory_order_relaxed) == seq;
+			}
+
+			//! check that the publisher has not started to overwrite the frame yet
+			bool IsValid(const Frame& frame) const
+			{
+				std::atomic_thread_fence(std::memory_order_acquire);
+				return frame.slot < header_->slot_count
+					&& slots_[frame.slot].seq.load(std::memory_order_relaxed) == frame.seq;
+			}
+
+			uint64_t GetFrameCount() const
+			{
+				return header_->frame.load(std::memory_order_acquire);
+			}
+
+			cv::Size GetSize() const
+			{
+				return { header_->cols, header_->rows };
+			}
+
+		private:
+			Region region_;
+			const RingHeader* header_;
+			const SlotHeader* slots_;
+		};
+	}
+
+	namespace pack
+	{
+		//! single-file figure container:
+		//!   FileHeader | Block | Block | ... | TOC (BlockHeader x block_count)
+		//! every block is a 64-byte BlockHeader followed by its payload, both aligned
+		//! to 64 bytes, so raw column data can be used in place from a mapping.
+		//! blocks are written in load order (figure, then per view: view, series, data, ...)
+		typedef int Flags;
+
+		static const Flags None = 0;
+		static const Flags Checksum = 1;
+		static const Flags Compress = 2; //! gorilla-encoded data blocks
+
+		static const char MAGIC[4] = { 'C', 'V', 'P', 'K' };
+		static const uint16_t VERSION = 1;
+		static const size_t ALIGNMENT = 64;
+
+		namespace block
+		{
+			typedef uint32_t Kind;
+
+			static const Kind Figure = 1;
+			static const Kind View = 2;
+			static const Kind Series = 3;
+			static const Kind Data = 4;
+		}
+
+		struct FileHeader
+		{
+			char magic[4];
+			uint16_t version;
+			uint16_t flags;
+			uint32_t block_count;
+			uint32_t reserved;
+			uint64_t toc_offset;
+			byte padding[40];
+		};
+
+		struct BlockHeader
+		{
+			block::Kind kind;
+			uint32_t flags;
+			uint32_t view;
+			uint32_t series;
+			uint64_t size;
+			uint64_t offset; //! payload offset from the beginning of the file
+			uint32_t checksum;
+			byte padding[28];
+		};
+
+		static_assert(sizeof(FileHeader) == ALIGNMENT && sizeof(BlockHeader) == ALIGNMENT, "pack headers must be 64 bytes");
+
+		static uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0)
+		{
+			static const struct Table
+			{
+				uint32_t v[256];
+				Table()
+				{
+					for (uint32_t i = 0; i < 256; ++i)
+					{
+						uint32_t c = i;
+						for (int k = 0; k < 8; ++k)
+						{
+							c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+						}
+						v[i] = c;
+					}
+				}
+			} table;
+
+			auto p = (const byte*)data;
+			crc = ~crc;
+			for (size_t i = 0; i < size; ++i)
+			{
+				crc = table.v[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+			}
+			return ~crc;
+		}
+
+		static uint64_t AlignUp(uint64_t n)
+		{
+			return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		}
+
+		//! true if the file starts with the pack magic, Figure::Load and View::Load
+		//! use it to accept a pack in place of the text metadata
+		static bool IsPack(const std::string& filename)
+		{
+			FILE* fp = util::OpenFile(filename, "rb");
+			if (fp == nullptr)
+			{
+				return false;
+			}
+			char magic[sizeof(MAGIC)];
+			bool match = fread(magic, sizeof(magic), 1, fp) == 1 && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+			fclose(fp);
+			return match;
+		}
+
+		//! little helper for (de)serializing metadata blocks
+		class Buffer
+		{
+		public:
+			Buffer() : pos_(0)
+			{
+				//
+			}
+
+			Buffer(std::vector<byte>&& data) : data_(std::move(data)), pos_(0)
+			{
+				//
+			}
+
+			Buffer& PutInt(int32_t v)
+			{
+				return Put_(&v, sizeof(v));
+			}
+
+			Buffer& PutUInt64(uint64_t v)
+			{
+				return Put_(&v, sizeof(v));
+			}
+
+			Buffer& PutString(const std::string& s)
+			{
+				PutInt((int32_t)s.size());
+				return Put_(s.data(), s.size());
+			}
+
+			Buffer& PutColor(const Color& color)
+			{
+				auto vec4 = color.ToVec4b(); //BGRA
+				return Put_(&vec4[0], 4);
+			}
+
+			int32_t GetInt()
+			{
+				int32_t v;
+				Get_(&v, sizeof(v));
+				return v;
+			}
+
+			uint64_t GetUInt64()
+			{
+				uint64_t v;
+				Get_(&v, sizeof(v));
+				return v;
+			}
+
+			std::string GetString()
+			{
+				auto n = GetInt();
+				if (n < 0 || pos_ + n > data_.size())
+				{
+					throw std::runtime_error("corrupted pack block");
+				}
+				std::string s((const char*)data_.data() + pos_, n);
+				pos_ += n;
+				return s;
+			}
+
+			Color GetColor()
+			{
+				byte bgra[4];
+				Get_(bgra, 4);
+				return Color(bgra[2], bgra[1], bgra[0], bgra[3]);
+			}
+
+			const std::vector<byte>& GetData() const
+			{
+				return data_;
+			}
+
+		private:
+			Buffer& Put_(const void* p, size_t n)
+			{
+				data_.insert(data_.end(), (const byte*)p, (const byte*)p + n);
+				return *this;
+			}
+
+			void Get_(void* p, size_t n)
+			{
+				if (pos_ + n > data_.size())
+				{
+					throw std::runtime_error("corrupted pack block");
+				}
+				memcpy(p, data_.data() + pos_, n);
+				pos_ += n;
+			}
+
+		private:
+			std::vector<byte> data_;
+			size_t pos_;
+		};
+
+		class Writer
+		{
+		public:
+			Writer(const std::string& filename, Flags flags = None)
+				: fp_(nullptr), flags_(flags), pos_(0), failed_(false)
+			{
+				fp_ = util::OpenFile(filename, "wb");
+				if (fp_ == nullptr)
+				{
+					throw std::runtime_error("failed to create pack");
+				}
+				FileHeader header = {};
+				try
+				{
+					Put_(&header, sizeof(header));
+				}
+				catch (...)
+				{
+					//! the destructor doesn't run for a throwing constructor. the empty
+					//! file is left like a failed pack, Reader rejects it
+					fclose(fp_);
+					throw;
+				}
+				pos_ = sizeof(header);
+			}
+
+			//! a pack with a failed write keeps its zeroed file header, so it is
+			//! rejected by Reader instead of being finalized with missing blocks
+			~Writer()
+			{
+				Close_();
+			}
+
+			Writer(const Writer&) = delete;
+			Writer& operator=(const Writer&) = delete;
+
+			void Write(block::Kind kind, uint32_t view, uint32_t series, const void* data, size_t size, uint32_t blockFlags = 0)
+			{
+				BlockHeader header = {};
+				header.kind = kind;
+				header.flags = blockFlags;
+				header.view = view;
+				header.series = series;
+				header.size = size;
+				header.offset = pos_ + sizeof(BlockHeader);
+				if (flags_ & Checksum)
+				{
+					header.flags |= Checksum;
+					header.checksum = Crc32(data, size);
+				}
+				Put_(&header, sizeof(header));
+				Put_(data, size);
+				pos_ = header.offset + size;
+				Pad_();
+				toc_.push_back(header);
+			}
+
+			void Write(block::Kind kind, uint32_t view, uint32_t series, const Buffer& buffer)
+			{
+				Write(kind, view, series, buffer.GetData().data(), buffer.GetData().size());
+			}
+
+			Flags GetFlags() const
+			{
+				return flags_;
+			}
+
+			//! write the table of contents and the file header, throws if any write failed
+			void Close()
+			{
+				if (!Close_())
+				{
+					throw std::runtime_error("failed to write pack");
+				}
+			}
+
+		private:
+			bool Close_()
+			{
+				if (fp_ == nullptr)
+				{
+					return !failed_;
+				}
+
+				if (!failed_)
+				{
+					FileHeader header = {};
+					memcpy(header.magic, MAGIC, sizeof(MAGIC));
+					header.version = VERSION;
+					header.flags = (uint16_t)flags_;
+					header.block_count = (uint32_t)toc_.size();
+					header.toc_offset = pos_;
+					failed_ = fwrite(toc_.data(), sizeof(BlockHeader), toc_.size(), fp_) != toc_.size()
+						|| fflush(fp_) != 0;
+					if (!failed_)
+					{
+						util::Seek64(fp_, 0);
+						failed_ = fwrite(&header, sizeof(header), 1, fp_) != 1;
+					}
+				}
+				failed_ = fclose(fp_) != 0 || failed_;
+				fp_ = nullptr;
+				return !failed_;
+			}
+
+			void Put_(const void* data, size_t size)
+			{
+				if (failed_)
+				{
+					throw std::runtime_error("failed to write pack");
+				}
+				if (size > 0 && fwrite(data, 1, size, fp_) != size)
+				{
+					failed_ = true;
+					throw std::runtime_error("failed to write pack");
+				}
+			}
+
+			void Pad_()
+			{
+				static const byte zeros[ALIGNMENT] = { 0 };
+				auto aligned = AlignUp(pos_);
+				if (aligned > pos_)
+				{
+					Put_(zeros, (size_t)(aligned - pos_));
+					pos_ = aligned;
+				}
+			}
+
+		private:
+			FILE* fp_;
+			Flags flags_;
+			uint64_t pos_;
+			bool failed_;
+			std::vector<BlockHeader> toc_;
+		};
+
+		//! reads a pack either with buffered sequential I/O or through a file mapping
+		class Reader
+		{
+		public:
+			Reader(const std::string& filename, bool mapped = false)
+				: fp_(nullptr), pos_(0), next_(sizeof(FileHeader))
+			{
+				if (mapped)
+				{
+					file_.reset(new util::MappedFile(filename));
+					if (file_->GetSize() < sizeof(FileHeader))
+					{
+						throw std::runtime_error("invalid pack");
+					}
+					memcpy(&header_, file_->GetData(), sizeof(header_));
+				}
+				else
+				{
+					fp_ = util::OpenFile(filename, "rb");
+					if (fp_ == nullptr)
+					{
+						throw std::runtime_error("failed to open pack");
+					}
+					setvbuf(fp_, nullptr, _IOFBF, 1 << 20);
+					if (fread(&header_, sizeof(header_), 1, fp_) != 1)
+					{
+						fclose(fp_);
+						throw std::runtime_error("invalid pack");
+					}
+					pos_ = sizeof(header_);
+				}
+
+				if (memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0 || header_.version != VERSION
+					|| (file_ && header_.toc_offset + header_.block_count * sizeof(BlockHeader) > file_->GetSize()))
+				{
+					Close_();
+					throw std::runtime_error("invalid pack");
+				}
+			}
+
+			~Reader()
+			{
+				Close_();
+			}
+
+			Reader(const Reader&) = delete;
+			Reader& operator=(const Reader&) = delete;
+
+			//! advance to the next block in file order, payloads not read are skipped
+			bool Next(BlockHeader& header)
+			{
+				if (next_ >= header_.toc_offset)
+				{
+					return false;
+				}
+				Fetch_(next_, &header, sizeof(header));
+				if (header.offset != next_ + sizeof(BlockHeader))
+				{
+					throw std::runtime_error("corrupted pack");
+				}
+				next_ = AlignUp(header.offset + header.size);
+				return true;
+			}
+
+			//! the table of contents, for random access to single views
+			std::vector<BlockHeader> GetTableOfContents()
+			{
+				std::vector<BlockHeader> toc(header_.block_count);
+				if (!toc.empty())
+				{
+					Fetch_(header_.toc_offset, toc.data(), toc.size() * sizeof(BlockHeader));
+				}
+				return toc;
+			}
+
+			void Read(const BlockHeader& header, void* data)
+			{
+				Fetch_(header.offset, data, (size_t)header.size);
+				Verify_(header, data);
+			}
+
+			Buffer ReadBuffer(const BlockHeader& header)
+			{
+				std::vector<byte> data((size_t)header.size);
+				Read(header, data.data());
+				return Buffer(std::move(data));
+			}
+
+			bool IsMapped() const
+			{
+				return (bool)file_;
+			}
+
+			std::shared_ptr<util::MappedFile> GetMapping() const
+			{
+				return file_;
+			}
+
+			//! payload of a block inside the mapping, no copy is made
+			const byte* Map(const BlockHeader& header)
+			{
+				if (!file_ || header.offset + header.size > file_->GetSize())
+				{
+					throw std::runtime_error("truncated pack");
+				}
+				auto data = file_->GetData() + header.offset;
+				Verify_(header, data);
+				return data;
+			}
+
+		private:
+			void Fetch_(uint64_t offset, void* data, size_t size)
+			{
+				if (file_)
+				{
+					if (offset + size > file_->GetSize())
+					{
+						throw std::runtime_error("truncated pack");
+					}
+					memcpy(data, file_->GetData() + offset, size);
+					return;
+				}
+
+				if (pos_ != offset)
+				{
+					util::Seek64(fp_, offset);
+				}
+				if (size > 0 && fread(data, 1, size, fp_) != size)
+				{
+					throw std::runtime_error("truncated pack");
+				}
+				pos_ = offset + size;
+			}
+
+			void Verify_(const BlockHeader& header, const void* data)
+			{
+				if ((header.flags & Checksum) && Crc32(data, (size_t)header.size) != header.checksum)
+				{
+					throw std::runtime_error("pack block checksum mismatch");
+				}
+			}
+
+			void Close_()
+			{
+				if (fp_)
+				{
+					fclose(fp_);
+					fp_ = nullptr;
+				}
+			}
+
+		private:
+			FILE* fp_;
+			std::shared_ptr<util::MappedFile> file_;
+			FileHeader header_;
+			uint64_t pos_;
+			uint64_t next_;
+		};
+	}
+
+	namespace journal
+	{
+		//! append-only journal next to a series snapshot (.sdp + .sdp.bin):
+		//!   FileHeader | Record | Record | ...
+		//! each record is a RecordHeader followed by its payload, a torn or corrupted
+		//! tail is ignored on replay. the snapshot metadata stores the journal id so a
+		//! journal left over from an older snapshot is never replayed
+		static const char MAGIC[4] = { 'C', 'V', 'J', 'N' };
+		static const uint32_t RECORD_MAGIC = 0x524A5643; // "CVJR"
+		static const uint32_t VERSION = 1;
+
+		static const uint32_t Append = 1; //! raw values appended to the series
+		static const uint32_t Style = 2;  //! chart type, marker, legend and color
+
+		//! a checkpoint compacts (rewrites the snapshot) once the journal outgrows both
+		static const uint64_t COMPACT_MIN_BYTES = 1 << 20;
+		static const uint32_t COMPACT_MAX_RECORDS = 10000;
+
+		struct FileHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint64_t id;
+		};
+
+		struct RecordHeader
+		{
+			uint32_t magic;
+			uint32_t type;
+			uint64_t size;
+			uint32_t checksum;
+			uint32_t reserved;
+		};
+
+		//! checkpoint bookkeeping of a journaled series
+		struct State
+		{
+			std::string filename;
+			uint64_t id = 0;
+			uint64_t epoch = 0;
+			size_t committed = 0;
+			uint64_t snapshot_bytes = 0;
+			uint64_t journal_bytes = 0;
+			uint32_t records = 0;
+			std::vector<byte> style;
+		};
+
+		static uint64_t NewId()
+		{
+			static std::atomic<uint64_t> counter(0);
+			auto now = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+			auto id = (now ^ (++counter * 0x9E3779B97F4A7C15ULL)) | 1;
+			return id;
+		}
+
+		static bool WriteRecord(FILE* fp, uint32_t type, const void* data, size_t size)
+		{
+			RecordHeader header = {};
+			header.magic = RECORD_MAGIC;
+			header.type = type;
+			header.size = size;
+			header.checksum = pack::Crc32(data, size);
+			return fwrite(&header, sizeof(header), 1, fp) == 1
+				&& (size == 0 || fwrite(data, 1, size, fp) == size);
+		}
+	}
+
+	class View;
+
+	namespace live
+	{
+		//! backpressure counters of a live queue
+		struct Stats
+		{
+			size_t capacity = 0;
+			size_t depth = 0;      //! samples waiting to be drained
+			size_t high_water = 0; //! deepest depth seen by the consumer
+			uint64_t pushed = 0;
+			uint64_t dropped = 0;  //! rejected because the queue was full, or discarded by the consumer
+			uint64_t drained = 0;
+		};
+
+		//! bounded lock-free queue of samples (1 to 3 values each), any number of
+		//! producers, one consumer (the render thread). a full queue drops the new
+		//! sample instead of blocking the producer
+		class Queue
+		{
+		public:
+			Queue(int dimension, size_t capacity = 1 << 16)
+				: dimension_(dimension),
+				head_(0),
+				tail_(0),
+				pushed_(0),
+				dropped_(0),
+				drained_(0),
+				high_water_(0)
+			{
+				if (dimension < 1 || dimension > MAX_DIMENSION)
+				{
+					throw std::invalid_argument("invalid live queue dimension");
+				}
+				size_t size = 2;
+				while (size < capacity)
+				{
+					size <<= 1;
+				}
+				mask_ = size - 1;
+				cells_.reset(new Cell[size]);
+				for (size_t i = 0; i < size; ++i)
+				{
+					cells_[i].seq.store(i, std::memory_order_relaxed);
+				}
+			}
+
+			Queue(const Queue&) = delete;
+			Queue& operator=(const Queue&) = delete;
+
+			bool Push(double value)
+			{
+				return dimension_ == 1 && Push_(&value);
+			}
+
+			bool Push(double x, double y)
+			{
+				double values[] = { x, y };
+				return dimension_ == 2 && Push_(values);
+			}
+
+			bool Push(double x, double y, double z)
+			{
+				double values[] = { x, y, z };
+				return dimension_ == 3 && Push_(values);
+			}
+
+			//! consumer only: append up to `max` samples to values, returns the sample count
+			size_t Drain(std::vector<double>& values, size_t max = SIZE_MAX)
+			{
+				auto count = Take_(values, max);
+				drained_.fetch_add(count, std::memory_order_relaxed);
+				return count;
+			}
+
+			//! consumer only: remove up to `max` samples the consumer can't use, they
+			//! are counted as dropped
+			size_t Discard(size_t max = SIZE_MAX)
+			{
+				std::vector<double> values;
+				auto count = Take_(values, max);
+				dropped_.fetch_add(count, std::memory_order_relaxed);
+				return count;
+			}
+
+			Stats GetStats() const
+			{
+				Stats stats;
+				stats.capacity = mask_ + 1;
+				auto head = head_.load(std::memory_order_relaxed);
+				auto tail = tail_.load(std::memory_order_relaxed);
+				stats.depth = head > tail ? head - tail : 0;
+				stats.high_water = high_water_.load(std::memory_order_relaxed);
+				stats.pushed = pushed_.load(std::memory_order_relaxed);
+				stats.dropped = dropped_.load(std::memory_order_relaxed);
+				stats.drained = drained_.load(std::memory_order_relaxed);
+				return stats;
+			}
+
+			int GetDimension() const
+			{
+				return dimension_;
+			}
+
+		private:
+			static const int MAX_DIMENSION = 3;
+
+			//! a cell is free for position p when seq == p, and filled when seq == p + 1
+			struct Cell
+			{
+				std::atomic<size_t> seq;
+				double values[MAX_DIMENSION];
+			};
+
+			size_t Take_(std::vector<double>& values, size_t max)
+			{
+				auto pos = tail_.load(std::memory_order_relaxed);
+				auto depth = head_.load(std::memory_order_relaxed) - pos;
+				if (depth > high_water_.load(std::memory_order_relaxed))
+				{
+					high_water_.store(depth, std::memory_order_relaxed);
+				}
+
+				size_t count = 0;
+				while (count < max)
+				{
+					auto& cell = cells_[pos & mask_];
+					if (cell.seq.load(std::memory_order_acquire) != pos + 1)
+					{
+						break;
+					}
+					values.insert(values.end(), cell.values, cell.values + dimension_);
+					cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+					++pos;
+					++count;
+				}
+				tail_.store(pos, std::memory_order_relaxed);
+				return count;
+			}
+
+			bool Push_(const double* values)
+			{
+				auto pos = head_.load(std::memory_order_relaxed);
+				Cell* cell = nullptr;
+				for (;;)
+				{
+					cell = &cells_[pos & mask_];
+					auto seq = cell->seq.load(std::memory_order_acquire);
+					auto diff = (intptr_t)seq - (intptr_t)pos;
+					if (diff == 0)
+					{
+						if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							break;
+						}
+					}
+					else if (diff < 0)
+					{
+						dropped_.fetch_add(1, std::memory_order_relaxed);
+						return false;
+					}
+					else
+					{
+						pos = head_.load(std::memory_order_relaxed);
+					}
+				}
+
+				memcpy(cell->values, values, dimension_ * sizeof(double));
+				cell->seq.store(pos + 1, std::memory_order_release);
+				pushed_.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			const int dimension_;
+			size_t mask_;
+			std::unique_ptr<Cell[]> cells_;
+			alignas(64) std::atomic<size_t> head_;
+			alignas(64) std::atomic<size_t> tail_;
+			alignas(64) std::atomic<uint64_t> pushed_;
+			std::atomic<uint64_t> dropped_;
+			alignas(64) std::atomic<uint64_t> drained_;
+			std::atomic<size_t> high_water_;
+		};
+
+		//! frame timing of Figure::Poll / RunLive, times in milliseconds
+		struct FrameStats
+		{
+			uint64_t frames = 0;
+			uint64_t presented = 0; //! frames that changed the composite (imshow)
+			uint64_t late = 0;      //! frames that took longer than the RunLive budget
+			double last_ms = 0;     //! update + render + imshow of the last frame
+			double avg_ms = 0;      //! exponential moving average of last_ms
+			double max_ms = 0;
+			double fps = 0;         //! measured from the interval between frames
+		};
+
+		//! feeds a view from outside (e.g. metric::Flusher), called by View::Drain on the render thread
+		class Source
+		{
+		public:
+			virtual ~Source()
+			{
+				//
+			}
+
+			virtual void Feed(View& view) = 0;
+		};
+	}
+
+	namespace pyramid
+	{
+		//! samples summarized by one leaf
+		static const size_t BLOCK = 64;
+
+		//! per dimension min/max over blocks of BLOCK samples, each level above halves the
+		//! node count. appending only recomputes the last leaf and its ancestors, a range
+		//! query scans at most 2 * BLOCK samples plus O(log n) nodes
+		class MinMax
+		{
+		public:
+			void Reset()
+			{
+				levels_.clear();
+				count_ = 0;
+				dimension_ = 0;
+			}
+
+			//! samples covered so far
+			size_t GetCount() const
+			{
+				return count_;
+			}
+
+			//! bring the summary up to count samples (count * dimension values at data),
+			//! samples holding Inf/NaN are skipped when filter is set, NaN values always
+			void Update(const double* data, size_t count, int dimension, bool filter)
+			{
+				if (dimension != dimension_ || filter != filter_ || count < count_)
+				{
+					Reset();
+					dimension_ = dimension;
+					filter_ = filter;
+				}
+				if (count == count_ || dimension_ < 1)
+				{
+					return;
+				}
+
+				auto stride = 2 * (size_t)dimension_;
+				auto first = count_ / BLOCK;
+				auto nodes = (count + BLOCK - 1) / BLOCK;
+				if (levels_.empty())
+				{
+					levels_.emplace_back();
+				}
+				levels_[0].resize(nodes * stride);
+				for (auto b = first; b < nodes; ++b)
+				{
+					auto node = &levels_[0][b * stride];
+					Empty_(node);
+					Scan_(data, b * BLOCK, std::min(count, (b + 1) * BLOCK), node);
+				}
+
+				for (size_t k = 0; nodes > 1; ++k)
+				{
+					first /= 2;
+					nodes = (nodes + 1) / 2;
+					if (levels_.size() < k + 2)
+					{
+						levels_.emplace_back();
+					}
+					auto& children = levels_[k];
+					auto& parents = levels_[k + 1];
+					auto child_count = children.size() / stride;
+					parents.resize(nodes * stride);
+					for (auto i = first; i < nodes; ++i)
+					{
+						auto node = &parents[i * stride];
+						Empty_(node);
+						Merge_(node, &children[2 * i * stride]);
+						if (2 * i + 1 < child_count)
+						{
+							Merge_(node, &children[(2 * i + 1) * stride]);
+						}
+					}
+				}
+				count_ = count;
+			}
+
+			//! min/max of the samples [begin, end), false if none of them counts.
+			//! data must be what the last Update saw
+			bool Query(const double* data, size_t begin, size_t end, double* mins, double* maxs) const
+			{
+				for (int j = 0; j < dimension_; ++j)
+				{
+					mins[j] = DBL_MAX;
+					maxs[j] = -DBL_MAX;
+				}
+				end = std::min(end, count_);
+				if (begin >= end || dimension_ < 1)
+				{
+					return false;
+				}
+
+				auto first_block = (begin + BLOCK - 1) / BLOCK;
+				auto last_block = end / BLOCK;
+				if (first_block >= last_block)
+				{
+					Scan_(data, begin, end, mins, maxs);
+				}
+				else
+				{
+					Scan_(data, begin, first_block * BLOCK, mins, maxs);
+					Scan_(data, last_block * BLOCK, end, mins, maxs);
+
+					//! bottom-up walk: a node is taken whenever the range boundary is not
+					//! aligned to its parent
+					auto stride = 2 * (size_t)dimension_;
+					auto l = first_block;
+					auto r = last_block;
+					for (size_t k = 0; l < r && k < levels_.size(); ++k)
+					{
+						if (l & 1)
+						{
+							Merge_(mins, maxs, &levels_[k][l++ * stride]);
+						}
+						if (r & 1)
+						{
+							Merge_(mins, maxs, &levels_[k][--r * stride]);
+						}
+						l /= 2;
+						r /= 2;
+					}
+				}
+				return mins[0] <= maxs[0];
+			}
+
+			//! bytes held by the summary
+			size_t GetMemory() const
+			{
+				size_t bytes = 0;
+				for (auto& level : levels_)
+				{
+					bytes += level.capacity() * sizeof(double);
+				}
+				return bytes;
+			}
+
+		private:
+			void Empty_(double* node) const
+			{
+				for (int j = 0; j < dimension_; ++j)
+				{
+					node[j] = DBL_MAX;
+					node[dimension_ + j] = -DBL_MAX;
+				}
+			}
+
+			void Merge_(double* node, const double* other) const
+			{
+				Merge_(node, node + dimension_, other);
+			}
+
+			void Merge_(double* mins, double* maxs, const double* other) const
+			{
+				for (int j = 0; j < dimension_; ++j)
+				{
+					mins[j] = std::min(mins[j], other[j]);
+					maxs[j] = std::max(maxs[j], other[dimension_ + j]);
+				}
+			}
+
+			void Scan_(const double* data, size_t begin, size_t end, double* node) const
+			{
+				Scan_(data, begin, end, node, node + dimension_);
+			}
+
+			void Scan_(const double* data, size_t begin, size_t end, double* mins, double* maxs) const
+			{
+				for (auto i = begin; i < end; ++i)
+				{
+					auto p = data + i * dimension_;
+					if (filter_)
+					{
+						bool finite = true;
+						for (int j = 0; j < dimension_; ++j)
+						{
+							finite = finite && std::isfinite(p[j]);
+						}
+						if (!finite)
+						{
+							continue;
+						}
+					}
+					for (int j = 0; j < dimension_; ++j)
+					{
+						//! comparisons are false for NaN, so it never becomes a bound
+						if (p[j] < mins[j])
+						{
+							mins[j] = p[j];
+						}
+						if (p[j] > maxs[j])
+						{
+							maxs[j] = p[j];
+						}
+					}
+				}
+			}
+
+			std::vector<std::vector<double>> levels_; //! levels_[0] leaves, each node: mins then maxs
+			size_t count_ = 0;
+			int dimension_ = 0;
+			bool filter_ = false;
+		};
+	}
+
+	namespace raster
+	{
+		//! coverage of a 1 px LINE_AA stroke by minor axis distance from its center, 1/16 px
+		//! steps up to 1.5 px, as cv::line draws it
+		static const int PROFILE[] =
+		{
+			232, 232, 229, 224, 219, 212, 202, 190, 177, 162, 147, 130, 114, 98, 83, 68,
+			 56,  44,  35,  27,  20,  15,  11,   7,   3,   0,
+		};
+
+		//! gain (/256) of a 1 px stroke by slope |minor / major| in 1/16 steps, cv::line
+		//! draws diagonals heavier
+		static const int SLOPE_GAIN[] =
+		{
+			256, 256, 257, 258, 260, 263, 267, 270, 274, 278, 282, 288, 292, 297, 302, 307, 311,
+		};
+
+		//! gain (/256) on the first and last pixel of a 1 px stroke
+		static const int END_GAIN = 160;
+
+		//! batched LINE_AA strokes on a CV_8UC4 target: segments accumulate coverage in an 8 bit
+		//! mask (overlaps combine like repeated blends of one color), Blend then mixes every
+		//! touched row span once. matches cv::polylines within a few levels. the mask is per
+		//! thread, one canvas at a time
+		class Canvas
+		{
+		public:
+			//! targets above this many pixels get a mask of their own, freed with the canvas
+			static const size_t MAX_SCRATCH = 1 << 24;
+
+			explicit Canvas(cv::Mat& target) :
+				target_(target),
+				mask_(target.total() > MAX_SCRATCH ? own_ : Scratch_().mask),
+				lo_(target.rows, INT_MAX),
+				hi_(target.rows, -1),
+				top_(INT_MAX),
+				bottom_(-1)
+			{
+				if (target.type() != CV_8UC4)
+				{
+					throw std::invalid_argument("raster::Canvas needs a CV_8UC4 target");
+				}
+				if (&mask_ == &own_)
+				{
+					own_.resize(target.total());
+				}
+				else
+				{
+					Scratch_().Fit(target.total());
+				}
+			}
+
+			~Canvas()
+			{
+				Clear_();
+			}
+
+			Canvas(const Canvas&) = delete;
+			Canvas& operator=(const Canvas&) = delete;
+
+			//! open polyline through count points, segments are clipped to the target
+			Canvas& Polyline(const cv::Point* pts, size_t count, int thickness = 1)
+			{
+				for (size_t i = 1; i < count; ++i)
+				{
+					Segment(pts[i - 1], pts[i], thickness);
+				}
+				if (count == 1)
+				{
+					Segment(pts[0], pts[0], thickness);
+				}
+				return *this;
+			}
+
+			Canvas& Segment(cv::Point p0, cv::Point p1, int thickness = 1)
+			{
+				if (thickness > 1)
+				{
+					Thick_(p0.x, p0.y, p1.x, p1.y, (thickness + 1) / 2);
+				}
+				else
+				{
+					Thin_(p0.x, p0.y, p1.x, p1.y);
+				}
+				return *this;
+			}
+
+			//! mix color into the target by the accumulated coverage, and reset it
+			Canvas& Blend(const cv::Scalar& color)
+			{
+				//! channels 0, 2 and 1, 3 share a 32 bit word, 8 bits of headroom each for the product
+				byte bytes[4];
+				for (int i = 0; i < 4; ++i)
+				{
+					bytes[i] = (byte)std::max(0.0, std::min(255.0, color[i] + 0.5));
+				}
+				uint32_t packed;
+				memcpy(&packed, bytes, 4);
+				uint32_t c02 = packed & 0x00FF00FF;
+				uint32_t c13 = (packed >> 8) & 0x00FF00FF;
+				for (int y = top_; y <= bottom_; ++y)
+				{
+					if (hi_[y] < lo_[y])
+					{
+						continue;
+					}
+					int n = hi_[y] - lo_[y] + 1;
+					auto m = &mask_[(size_t)y * target_.cols + lo_[y]];
+					auto px = target_.ptr<uint32_t>(y) + lo_[y];
+					//! branch free so the compiler vectorizes it
+					for (int i = 0; i < n; ++i)
+					{
+						uint32_t a = m[i] + (m[i] >> 7);
+						uint32_t d = px[i];
+						uint32_t d02 = ((d & 0x00FF00FF) * (256 - a) + c02 * a) >> 8;
+						uint32_t d13 = ((d >> 8) & 0x00FF00FF) * (256 - a) + c13 * a;
+						px[i] = (d02 & 0x00FF00FF) | (d13 & 0xFF00FF00);
+					}
+					memset(m, 0, n);
+					lo_[y] = INT_MAX;
+					hi_[y] = -1;
+				}
+				top_ = INT_MAX;
+				bottom_ = -1;
+				return *this;
+			}
+
+			//! bytes held by the per thread masks of all threads
+			static size_t GetScratchMemory()
+			{
+				return ScratchBytes_().load(std::memory_order_relaxed);
+			}
+
+		private:
+			static std::atomic<size_t>& ScratchBytes_()
+			{
+				static std::atomic<size_t> bytes(0);
+				return bytes;
+			}
+
+			//! per thread, all zero between canvases. it grows to the largest target and
+			//! shrinks back once a target needs less than a quarter of it
+			struct Scratch
+			{
+				std::vector<byte> mask;
+
+				~Scratch()
+				{
+					ScratchBytes_() -= mask.capacity();
+				}
+
+				void Fit(size_t size)
+				{
+					auto before = mask.capacity();
+					if (size > mask.size())
+					{
+						mask.resize(size);
+					}
+					else if (size < mask.size() / 4)
+					{
+						std::vector<byte>(size).swap(mask);
+					}
+					ScratchBytes_() += mask.capacity();
+					ScratchBytes_() -= before;
+				}
+			};
+
+			static Scratch& Scratch_()
+			{
+				thread_local Scratch scratch;
+				return scratch;
+			}
+
+			void Clear_()
+			{
+				for (int y = top_; y <= bottom_; ++y)
+				{
+					if (hi_[y] >= lo_[y])
+					{
+						memset(&mask_[(size_t)y * target_.cols + lo_[y]], 0, hi_[y] - lo_[y] + 1);
+					}
+				}
+				top_ = INT_MAX;
+				bottom_ = -1;
+			}
+
+			//! PROFILE at d / 256 px
+			static int Profile_(int d)
+			{
+				int i = d >> 4;
+				if (i >= 24)
+				{
+					return 0;
+				}
+				int f = d & 15;
+				return (PROFILE[i] * (16 - f) + PROFILE[i + 1] * f) >> 4;
+			}
+
+			//! union with the coverage so far: 1 - (1 - m)(1 - c). the caller extends the spans
+			void Add_(byte* m, int c)
+			{
+				*m = (byte)(*m + c - (*m * c + 127) / 255);
+			}
+
+			void Touch_(int y, int x0, int x1)
+			{
+				lo_[y] = std::min(lo_[y], x0);
+				hi_[y] = std::max(hi_[y], x1);
+			}
+
+			void TouchRows_(int first, int last)
+			{
+				top_ = std::min(top_, first);
+				bottom_ = std::max(bottom_, last);
+			}
+
+			//! walk the major axis in 16.16 fixed point, cover the pixels within 1.5 px on the
+			//! minor one
+			void Thin_(int x0, int y0, int x1, int y1)
+			{
+				bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+				if (steep)
+				{
+					std::swap(x0, y0);
+					std::swap(x1, y1);
+				}
+				if (x1 < x0)
+				{
+					std::swap(x0, x1);
+					std::swap(y0, y1);
+				}
+				int major = steep ? target_.rows : target_.cols;
+				int minor = steep ? target_.cols : target_.rows;
+				double slope = x1 == x0 ? 0 : (double)(y1 - y0) / (x1 - x0);
+				int s = (int)(std::abs(slope) * 16 * 256);
+				int gain = (SLOPE_GAIN[s >> 8] * (256 - (s & 255)) + SLOPE_GAIN[std::min(16, (s >> 8) + 1)] * (s & 255)) >> 8;
+
+				//! clip to the target, and to where the stroke reaches it on the minor axis
+				double lo = std::max(0, x0);
+				double hi = std::min(major - 1, x1);
+				if (y1 != y0)
+				{
+					double a = x0 + (-2 - y0) / slope;
+					double b = x0 + (minor + 1 - y0) / slope;
+					lo = std::max(lo, std::ceil(std::min(a, b)));
+					hi = std::min(hi, std::floor(std::max(a, b)));
+				}
+				else if (y0 < -2 || y0 > minor + 1)
+				{
+					return;
+				}
+				if (lo > hi)
+				{
+					return;
+				}
+
+				int begin = (int)lo;
+				int end = (int)hi;
+				auto y = (int64_t)std::llround((y0 + slope * (begin - x0)) * 65536);
+				auto step = (int64_t)std::llround(slope * 65536);
+				size_t pitch = target_.cols;
+				if (steep)
+				{
+					TouchRows_(begin, end);
+				}
+				else
+				{
+					auto y_end = y + step * (end - begin);
+					TouchRows_(std::max(0, (int)((std::min(y, y_end) - 0x18000 + 0xFFFF) >> 16)),
+						std::min(minor - 1, (int)((std::max(y, y_end) + 0x18000) >> 16)));
+				}
+				for (int x = begin; x <= end; ++x, y += step)
+				{
+					int g = (x == x0 || x == x1) ? (gain * END_GAIN) >> 8 : gain;
+					int first = std::max(0, (int)((y - 0x18000 + 0xFFFF) >> 16));
+					int last = std::min(minor - 1, (int)((y + 0x18000) >> 16));
+					if (steep)
+					{
+						auto m = &mask_[(size_t)x * pitch];
+						for (int k = first; k <= last; ++k)
+						{
+							Add_(m + k, std::min(255, (Profile_((int)(std::abs(((int64_t)k << 16) - y) >> 8)) * g) >> 8));
+						}
+						Touch_(x, first, last);
+					}
+					else
+					{
+						for (int k = first; k <= last; ++k)
+						{
+							Add_(&mask_[k * pitch + x], std::min(255, (Profile_((int)(std::abs(((int64_t)k << 16) - y) >> 8)) * g) >> 8));
+							Touch_(k, x, x);
+						}
+					}
+				}
+			}
+
+			//! capsule of radius r: full coverage up to r, the edge is half covered at r + 0.5.
+			//! along a row the distance to the line and the position along the segment are
+			//! linear in x, only the caps need a square root
+			void Thick_(int x0, int y0, int x1, int y1, int r)
+			{
+				float reach = r + 1.5f;
+				float dx = (float)(x1 - x0);
+				float dy = (float)(y1 - y0);
+				float len2 = dx * dx + dy * dy;
+				float len = std::sqrt(len2);
+				float nx = len > 0 ? dy / len : 0;    //! unit normal
+				float ny = len > 0 ? -dx / len : 0;
+				float tx = len > 0 ? dx / len2 : 0;   //! segment parameter per unit x
+				float ty = len > 0 ? dy / len2 : 0;
+				int first = std::max(0, (int)std::ceil(std::min(y0, y1) - reach));
+				int last = std::min(target_.rows - 1, (int)std::floor(std::max(y0, y1) + reach));
+				if (first > last)
+				{
+					return;
+				}
+				TouchRows_(first, last);
+				for (int y = first; y <= last; ++y)
+				{
+					//! the row crosses the band around the line in [left, right]
+					float left = std::min(x0, x1) - reach;
+					float right = std::max(x0, x1) + reach;
+					if (y1 != y0)
+					{
+						float center = x0 + (y - y0) * dx / dy;
+						float half = reach * len / std::abs(dy);
+						left = std::max(left, center - half);
+						right = std::min(right, center + half);
+					}
+					int a = std::max(0, (int)std::ceil(left));
+					int b = std::min(target_.cols - 1, (int)std::floor(right));
+					if (a > b)
+					{
+						continue;
+					}
+					auto m = &mask_[(size_t)y * target_.cols];
+					float ex = (float)(a - x0);
+					float ey = (float)(y - y0);
+					float p = ex * nx + ey * ny;
+					float t = len2 > 0 ? ex * tx + ey * ty : -1; //! a dot is all cap
+					for (int x = a; x <= b; ++x, p += nx, t += tx)
+					{
+						float d;
+						if (t >= 0 && t <= 1)
+						{
+							d = std::abs(p);
+						}
+						else
+						{
+							float cx = (float)(x - (t < 0 ? x0 : x1));
+							float cy = (float)(y - (t < 0 ? y0 : y1));
+							d = std::sqrt(cx * cx + cy * cy);
+						}
+						d = std::max(0.0f, d - r);
+						int c = d < 0.5f ? 255 - (int)(312 * d * d) : Profile_((int)(d * 256));
+						Add_(m + x, c);
+					}
+					Touch_(y, a, b);
+				}
+			}
+
+			cv::Mat& target_;
+			std::vector<byte> own_;   //! the mask of targets above MAX_SCRATCH
+			std::vector<byte>& mask_; //! target_.cols per row
+			std::vector<int> lo_;     //! touched columns of each row
+			std::vector<int> hi_;
+			int top_;                 //! touched rows
+			int bottom_;
+		};
+
+		//! cv::polylines(target, pts, false, color, thickness, cv::LINE_AA) on a CV_8UC4 target,
+		//! an (INT_MIN, INT_MIN) point splits the runs
+		static void Polylines(cv::Mat& target, const std::vector<cv::Point>& pts, const cv::Scalar& color, int thickness = 1)
+		{
+			if (target.type() != CV_8UC4)
+			{
+				std::vector<cv::Point> run;
+				for (auto& pt : pts)
+				{
+					if (pt.x == INT_MIN)
+					{
+						cv::polylines(target, run, false, color, thickness, cv::LINE_AA);
+						run.clear();
+					}
+					else
+					{
+						run.push_back(pt);
+					}
+				}
+				cv::polylines(target, run, false, color, thickness, cv::LINE_AA);
+				return;
+			}
+
+			Canvas canvas(target);
+			size_t begin = 0;
+			for (size_t i = 0; i <= pts.size(); ++i)
+			{
+				if (i == pts.size() || pts[i].x == INT_MIN)
+				{
+					canvas.Polyline(pts.data() + begin, i - begin, thickness);
+					begin = i + 1;
+				}
+			}
+			canvas.Blend(color);
+		}
+	}
+
+	namespace histogram
+	{
+		//! bin layout of a chart::Histogram series. the series values are (left edge, count)
+		//! per bin and (right edge, 0) last, so a sample costs one increment and is not kept,
+		//! and the bins dump, load and bound like any 2-D series
+		class Bins
+		{
+		public:
+			//! adaptive: the bins start narrow around the first value, when a value lands
+			//! outside they shift to it, or double their width by merging neighbours once
+			//! the values span more than count bins. edges are multiples of the width
+			explicit Bins(int count = 64)
+				: count_(std::max(1, count)),
+				adaptive_(true)
+			{
+				Reset();
+			}
+
+			//! fixed [lo, hi), values outside are only counted (GetUnderflow / GetOverflow)
+			Bins(double lo, double hi, int count)
+				: count_(std::max(1, count)),
+				adaptive_(false),
+				fixed_lo_(lo),
+				fixed_hi_(hi)
+			{
+				if (!(lo < hi) || !std::isfinite(lo) || !std::isfinite(hi))
+				{
+					throw std::invalid_argument("histogram range must be finite and lo < hi");
+				}
+				Reset();
+			}
+
+			//! forget the counts, Add lays the bins out again
+			void Reset()
+			{
+				underflow_ = 0;
+				overflow_ = 0;
+				adopt_ = false;
+				if (adaptive_)
+				{
+					lo_ = NAN;
+					width_ = 0;
+				}
+				else
+				{
+					lo_ = fixed_lo_;
+					width_ = (fixed_hi_ - fixed_lo_) / count_;
+				}
+				inv_width_ = width_ > 0 ? 1 / width_ : 0;
+			}
+
+			//! the values were replaced (loaded), the next Add takes over their edges
+			//! instead of counting into the old layout. the out of range counts restart
+			void Invalidate()
+			{
+				underflow_ = 0;
+				overflow_ = 0;
+				adopt_ = true;
+				inv_width_ = NAN; //! every Add misses until then
+			}
+
+			//! count value into values (the layout above), O(1) unless adaptive bins move.
+			//! NaN is ignored, values that don't fit the layout are replaced by it
+			void Add(std::vector<double>& values, double value)
+			{
+				auto k = (value - lo_) * inv_width_;
+				if (k >= 0 && k < count_ && values.size() == 2 * (size_t)count_ + 2)
+				{
+					values[2 * (size_t)k + 1] += 1;
+				}
+				else
+				{
+					Miss_(values, value);
+				}
+			}
+
+			int GetCount() const
+			{
+				return count_;
+			}
+
+			bool IsAdaptive() const
+			{
+				return adaptive_;
+			}
+
+			//! NaN until adaptive bins saw a value
+			double GetLow() const
+			{
+				return lo_;
+			}
+
+			double GetHigh() const
+			{
+				return lo_ + count_ * width_;
+			}
+
+			double GetWidth() const
+			{
+				return width_;
+			}
+
+			//! values below the fixed range, or -Inf
+			uint64_t GetUnderflow() const
+			{
+				return underflow_;
+			}
+
+			//! values at or above the fixed range, or +Inf
+			uint64_t GetOverflow() const
+			{
+				return overflow_;
+			}
+
+		private:
+			void Miss_(std::vector<double>& values, double value)
+			{
+				if (std::isnan(value))
+				{
+					return;
+				}
+				if (adopt_ || values.size() != 2 * (size_t)count_ + 2)
+				{
+					Adopt_(values);
+				}
+
+				auto k = (value - lo_) * inv_width_;
+				if (!(k >= 0 && k < count_))
+				{
+					if (!adaptive_ || std::isinf(value))
+					{
+						++(value < lo_ || value == -INFINITY ? underflow_ : overflow_);
+						return;
+					}
+					Move_(values, value);
+					k = (value - lo_) * inv_width_;
+				}
+				values[2 * std::min((size_t)k, (size_t)count_ - 1) + 1] += 1;
+			}
+
+			//! take over bins loaded from a dump, lay out empty ones otherwise
+			void Adopt_(std::vector<double>& values)
+			{
+				adopt_ = false;
+				auto n = values.size() / 2;
+				if (values.size() % 2 == 0 && n >= 2 && values[2] > values[0])
+				{
+					count_ = (int)(n - 1);
+					lo_ = values[0];
+					width_ = values[2] - values[0];
+					inv_width_ = 1 / width_;
+					return;
+				}
+
+				values.clear();
+				Reset();
+				if (!adaptive_)
+				{
+					Place_(values, {});
+				}
+			}
+
+			//! bring value into the window, first by shifting it over the occupied bins,
+			//! then by doubling the width until they fit
+			void Move_(std::vector<double>& values, double value)
+			{
+				//! occupied bins by absolute index (edge / width)
+				std::vector<std::pair<double, double>> cells;
+				if (width_ > 0)
+				{
+					auto k0 = std::floor(lo_ / width_ + 0.5);
+					for (int i = 0; i < count_; ++i)
+					{
+						if (values[2 * (size_t)i + 1] != 0)
+						{
+							cells.push_back({ k0 + i, values[2 * (size_t)i + 1] });
+						}
+					}
+				}
+				else
+				{
+					//! a first value, 2^20 bins per its magnitude, widened as values come
+					width_ = std::ldexp(1.0, value != 0 ? std::max(std::ilogb(value) - 20, -1000) : -1000);
+				}
+
+				double first;
+				double last;
+				while (true)
+				{
+					auto k = std::floor(value / width_);
+					first = cells.empty() ? k : std::min(k, cells.front().first);
+					last = cells.empty() ? k : std::max(k, cells.back().first);
+					if (last - first < count_)
+					{
+						break;
+					}
+					width_ *= 2;
+					size_t n = 0;
+					for (auto& cell : cells)
+					{
+						auto index = std::floor(cell.first / 2);
+						if (n > 0 && cells[n - 1].first == index)
+						{
+							cells[n - 1].second += cell.second;
+						}
+						else
+						{
+							cells[n++] = { index, cell.second };
+						}
+					}
+					cells.resize(n);
+				}
+
+				//! centered, the free bins split evenly on both sides
+				auto k0 = first - std::floor((count_ - (last - first + 1)) / 2);
+				lo_ = k0 * width_;
+				inv_width_ = 1 / width_;
+				for (auto& cell : cells)
+				{
+					cell.first -= k0;
+				}
+				Place_(values, cells);
+			}
+
+			//! edges from lo_ and width_, counts from cells (bin, count)
+			void Place_(std::vector<double>& values, const std::vector<std::pair<double, double>>& cells) const
+			{
+				values.assign(2 * (size_t)count_ + 2, 0);
+				for (int i = 0; i <= count_; ++i)
+				{
+					values[2 * (size_t)i] = lo_ + i * width_;
+				}
+				for (auto& cell : cells)
+				{
+					values[2 * (size_t)cell.first + 1] += cell.second;
+				}
+			}
+
+			int count_;
+			bool adaptive_;
+			double fixed_lo_ = 0;
+			double fixed_hi_ = 0;
+			double lo_;
+			double width_;
+			double inv_width_;
+			uint64_t underflow_;
+			uint64_t overflow_;
+			bool adopt_ = false;
+		};
+	}
+
+	class Series
+	{
+	public:
+		typedef double value_type;
+
+	private:
+		typedef std::vector<value_type> vector_type;
+
+	public:
+		Series(const std::string& label, chart::Type chartType, marker::Type markerType = marker::None)
+			: label_(label),
+			chart_type_(chartType),
+			marker_type_(markerType),
+			marker_size_({ 4,4 }),
+			dimension_(chart::GetDimension(chartType)),
+			enable_legend_(true),
+			render_color_(color::Blue),
+			mapped_(nullptr),
+			mapped_count_(0),
+			stored_count_(0),
+			stored_encoding_(dump::Raw),
+			stored_journal_(0),
+			filter_inf_nan_(false),
+			visible_count_(-1),
+			epoch_(0),
+			sorted_data_(nullptr),
+			sorted_count_(0),
+			sorted_x_(true),
+			enable_pyramid_(false),
+			pyramid_epoch_(0),
+			grid_extent_{ 0,1,0,1 },
+			dirty_(false)
+		{
+			enable_legend_ = (chartType != chart::Elevation && chartType != chart::Heatmap);
+		}
+
+		Series(Series& rhs, chart::Type chartType)
+			:label_(rhs.label_),
+			chart_type_(chartType),
+			marker_type_(rhs.marker_type_),
+			marker_size_(rhs.marker_size_),
+			dimension_(chart::GetDimension(chartType)),
+			enable_legend_(rhs.enable_legend_),
+			values_(std::move(rhs.Materialize_().values_)),
+			mapped_(nullptr),
+			mapped_count_(0),
+			stored_count_(0),
+			stored_encoding_(dump::Raw),
+			stored_journal_(0),
+			filter_inf_nan_(false),
+			visible_count_(-1),
+			epoch_(0),
+			sorted_data_(nullptr),
+			sorted_count_(0),
+			sorted_x_(true),
+			enable_pyramid_(false),
+			pyramid_epoch_(0),
+			grid_extent_{ 0,1,0,1 },
+			dirty_(true)
+		{
+			if (rhs.GetDimension() == 1 && dimension_ == 2)
+			{
+				auto n = values_.size();
+				vector_type values(n * 2);
+				for (auto i = 0; i < n; ++i)
+				{
+					values[2 * i] = i + 1;
+					values[2 * i + 1] = values_[i];
+				}
+				values_ = std::move(values);
+			}
+			else
+			{
+				throw std::runtime_error("invalid conversion (expect: dimension 1-->2)");
+			}
+		}
+
+		Series() :Series("", chart::Bar)
+		{
+			//
+		}
+
+		//! a copy is a snapshot: it neither drains the live queue nor appends to the
+		//! journal of rhs, both keep a single owner (see View::AddSeries)
+		Series(const Series& rhs)
+			: label_(rhs.label_),
+			chart_type_(rhs.chart_type_),
+			marker_type_(rhs.marker_type_),
+			marker_size_(rhs.marker_size_),
+			dimension_(rhs.dimension_),
+			enable_legend_(rhs.enable_legend_),
+			render_color_(rhs.render_color_),
+			values_(rhs.values_),
+			mapping_(rhs.mapping_),
+			mapped_(rhs.mapped_),
+			mapped_count_(rhs.mapped_count_),
+			stored_count_(rhs.stored_count_),
+			stored_encoding_(rhs.stored_encoding_),
+			stored_journal_(rhs.stored_journal_),
+			filter_inf_nan_(rhs.filter_inf_nan_),
+			visible_count_(rhs.visible_count_),
+			epoch_(rhs.epoch_),
+			sorted_data_(nullptr),
+			sorted_count_(0),
+			sorted_x_(true),
+			enable_pyramid_(rhs.enable_pyramid_),
+			pyramid_(rhs.pyramid_),
+			pyramid_epoch_(rhs.pyramid_epoch_),
+			bins_(rhs.bins_),
+			grid_(rhs.grid_),
+			grid_extent_{ rhs.grid_extent_[0], rhs.grid_extent_[1], rhs.grid_extent_[2], rhs.grid_extent_[3] },
+			dirty_(rhs.dirty_)
+		{
+			//
+		}
+
+		Series(Series&& rhs) = default;
+
+		//! takes over the values and the live queue of rhs, like a move
+		Series& operator=(Series& rhs)
+		{
+			if (this != &rhs)
+			{
+				label_ = rhs.label_;
+				chart_type_ = rhs.chart_type_;
+				marker_type_ = rhs.marker_type_;
+				marker_size_ = rhs.marker_size_;
+				dimension_ = rhs.dimension_;
+				enable_legend_ = rhs.enable_legend_;
+				values_ = std::move(rhs.values_);
+				mapping_ = rhs.mapping_;
+				mapped_ = rhs.mapped_;
+				mapped_count_ = rhs.mapped_count_;
+				stored_count_ = rhs.stored_count_;
+				stored_encoding_ = rhs.stored_encoding_;
+				stored_journal_ = rhs.stored_journal_;
+				++epoch_;
+				filter_inf_nan_ = rhs.filter_inf_nan_;
+				visible_count_ = rhs.visible_count_;
+				queue_ = std::move(rhs.queue_);
+				enable_pyramid_ = rhs.enable_pyramid_;
+				bins_ = rhs.bins_;
+				grid_ = rhs.grid_;
+				std::copy(rhs.grid_extent_, rhs.grid_extent_ + 4, grid_extent_);
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		Series& SetChartType(chart::Type chartType)
+		{
+			if (chart_type_ != chartType)
+			{
+				if ((chartType == chart::Histogram || chartType == chart::Heatmap) && Size_() > 0)
+				{
+					throw std::runtime_error("samples can't be converted to histogram bins or a grid");
+				}
+
+				int dimension = chart::GetDimension(chartType);
+				if (dimension_ == dimension)
+				{
+					chart_type_ = chartType;
+					dirty_ = true;
+				}
+				else
+				{
+					if (Size_() == 0)
+					{
+						chart_type_ = chartType;
+						dimension_ = dimension;
+						dirty_ = false;
+					}
+					else
+					{
+						throw std::runtime_error("dimension not match for the chart type");
+					}
+				}
+			}
+			return *this;
+		}
+
+		Series& SetMarkerType(marker::Type markerType)
+		{
+			if (marker_type_ != markerType)
+			{
+				marker_type_ = markerType;
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		Series& SetMarkerSize(cv::Size size)
+		{
+			if (marker_size_ != size)
+			{
+				marker_size_ = size;
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		Series& EnableLegend(bool enable)
+		{
+			if (enable_legend_ != enable)
+			{
+				enable_legend_ = enable;
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		Series& SetRenderColor(Color color)
+		{
+			if (render_color_ != color)
+			{
+				render_color_ = color;
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		//! attach a live queue that producer threads push into (see live::Queue),
+		//! the owning view drains it at the start of every render
+		Series& SetLive(size_t capacity = 1 << 16)
+		{
+			queue_ = std::make_shared<live::Queue>(InputDimension_(), capacity);
+			return *this;
+		}
+
+		//! share an existing queue, its dimension must match the chart type (1 for a histogram)
+		Series& SetLive(std::shared_ptr<live::Queue> queue)
+		{
+			if (queue && queue->GetDimension() != InputDimension_())
+			{
+				throw std::invalid_argument("live queue dimension mismatch");
+			}
+			queue_ = queue;
+			return *this;
+		}
+
+		//! handle for producers, stays valid even if the series is moved or removed
+		std::shared_ptr<live::Queue> GetLiveQueue() const
+		{
+			return queue_;
+		}
+
+		live::Stats GetLiveStats() const
+		{
+			return queue_ ? queue_->GetStats() : live::Stats();
+		}
+
+		//! move queued samples into the series (render thread only), returns the sample count
+		size_t Drain()
+		{
+			if (!queue_ || queue_->GetStats().depth == 0)
+			{
+				return 0;
+			}
+
+			Materialize_();
+			size_t count = 0;
+			if (chart_type_ == chart::Histogram && queue_->GetDimension() == 1)
+			{
+				vector_type raw;
+				count = queue_->Drain(raw);
+				for (auto v : raw)
+				{
+					bins_.Add(values_, v);
+				}
+				epoch_ += count > 0 ? 1 : 0;
+			}
+			else if (queue_->GetDimension() == dimension_)
+			{
+				count = queue_->Drain(values_);
+			}
+			else
+			{
+				queue_->Discard(); //! the chart type changed under the queue
+			}
+			if (count > 0)
+			{
+				dirty_ = true;
+			}
+			return count;
+		}
+
+		//! a histogram counts value into its bins. bins change in place without
+		//! changing the sample count, so the epoch moves to rebuild the pyramid
+		Series& AddValue(value_type value)
+		{
+			if (chart_type_ == chart::Histogram)
+			{
+				Materialize_();
+				bins_.Add(values_, value);
+				++epoch_;
+				dirty_ = true;
+				return *this;
+			}
+			if (dimension_ != 1)
+			{
+				return *this;
+			}
+
+			Materialize_();
+			values_.push_back(value);
+			dirty_ = true;
+			return *this;
+		}
+
+		//! a histogram counts every value into its bins
+		Series& AddValues(vector_type values)
+		{
+			if (chart_type_ == chart::Histogram)
+			{
+				Materialize_();
+				for (auto v : values)
+				{
+					bins_.Add(values_, v);
+				}
+				epoch_ += values.empty() ? 0 : 1;
+				dirty_ = dirty_ || !values.empty();
+				return *this;
+			}
+			if (dimension_ < 1)
+			{
+				return *this;
+			}
+
+			Materialize_();
+			auto count = (values.size() / dimension_) * dimension_;
+			if (values_.empty() && count == values.size())
+			{
+				values_ = std::move(values);
+			}
+			else
+			{
+				values_.insert(values_.end(), values.begin(), values.begin() + count);
+			}
+
+			if (count > 0)
+			{
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		Series& AppendArray(vector_type values)
+		{
+			if (dimension_ != 2 || chart_type_ == chart::Histogram)
+			{
+				return *this;
+			}
+
+			Materialize_();
+			auto idx = values_.size();
+			if (!values_.empty())
+			{
+				idx = values_[idx - 2];
+			}
+			auto count = values.size();
+			for (int i = 0; i < count; ++i)
+			{
+				values_.push_back(++idx);
+				values_.push_back(values[i]);
+			}
+
+			if (idx > 0)
+			{
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		Series& Clear()
+		{
+			if (Size_() > 0)
+			{
+				Unmap_();
+				values_.clear();
+				sorted_data_ = nullptr;
+				dirty_ = true;
+			}
+			bins_.Reset();
+			if (!grid_.empty())
+			{
+				grid_ = cv::Mat();
+				dirty_ = true;
+			}
+
+			return *this;
+		}
+
+		//! adaptive histogram bins (chart::Histogram), count of them. clears the counts
+		Series& SetBins(int count)
+		{
+			return SetBins_(histogram::Bins(count));
+		}
+
+		//! fixed histogram bins over [lo, hi), clears the counts
+		Series& SetBins(double lo, double hi, int count)
+		{
+			return SetBins_(histogram::Bins(lo, hi, count));
+		}
+
+		const histogram::Bins& GetBins() const
+		{
+			return bins_;
+		}
+
+		//! the cells of a chart::Heatmap: a single channel 8U/16U/32F/64F Mat, held by
+		//! reference (no copy, not dumped) and spanning [x0, x1] x [y0, y1], row 0 on top.
+		//! after writing it in place, View::Invalidate: a render rescans the z range
+		//! (cv::minMaxLoc) and maps the visible pixels through the color ramp
+		Series& SetGrid(const cv::Mat& grid, double x0, double x1, double y0, double y1)
+		{
+			if (chart_type_ != chart::Heatmap)
+			{
+				throw std::runtime_error("a grid needs chart::Heatmap");
+			}
+			auto depth = grid.depth();
+			if (grid.channels() != 1 || grid.dims > 2
+				|| (depth != CV_8U && depth != CV_16U && depth != CV_32F && depth != CV_64F))
+			{
+				throw std::invalid_argument("grid must be single channel 8U/16U/32F/64F");
+			}
+			if (!(x0 != x1) || !(y0 != y1) || !std::isfinite(x0 + x1 + y0 + y1))
+			{
+				throw std::invalid_argument("grid extent must be finite and not empty");
+			}
+
+			grid_ = grid;
+			grid_extent_[0] = x0;
+			grid_extent_[1] = x1;
+			grid_extent_[2] = y0;
+			grid_extent_[3] = y1;
+			dirty_ = true;
+			return *this;
+		}
+
+		//! one unit per cell, [0, cols] x [0, rows]
+		Series& SetGrid(const cv::Mat& grid)
+		{
+			return SetGrid(grid, 0, grid.cols, 0, grid.rows);
+		}
+
+		cv::Mat GetGrid() const
+		{
+			return grid_;
+		}
+
+		int GetDimension() const
+		{
+			return dimension_;
+		}
+
+		int GetSampleCount() const
+		{
+			if (chart_type_ == chart::Heatmap)
+			{
+				return (int)grid_.total();
+			}
+			if (dimension_ < 1)
+			{
+				return 0;
+			}
+			if (!filter_inf_nan_)
+			{
+				return (int)(Size_() / dimension_);
+			}
+			if (visible_count_ < 0)
+			{
+				int count = 0;
+				ForEachSample_([&count](const value_type*) { ++count; });
+				visible_count_ = count;
+			}
+			return visible_count_;
+		}
+
+		//! true if the values are served from a file mapping instead of owned memory
+		bool IsMapped() const
+		{
+			return (bool)mapping_;
+		}
+
+		std::string GetLabel() const
+		{
+			return label_;
+		}
+
+		chart::Type GetChartType() const
+		{
+			return chart_type_;
+		}
+
+		marker::Type GetMarkerType() const
+		{
+			return marker_type_;
+		}
+
+		cv::Size GetMarkerSize() const
+		{
+			return marker_size_;
+		}
+
+		bool IsLegendEnabled() const
+		{
+			return enable_legend_;
+		}
+
+		Color GetRenderColor() const
+		{
+			return render_color_;
+		}
+
+		bool IsDirty() const
+		{
+			return dirty_;
+		}
+
+		vector_type CalcMax() const
+		{
+			if (GetSampleCount() < 1)
+			{
+				return vector_type(dimension_, 0.0);
+			}
+			if (chart_type_ == chart::Heatmap)
+			{
+				vector_type mins;
+				vector_type maxs;
+				GridBounds_(mins, maxs);
+				return maxs;
+			}
+
+			vector_type maxs(dimension_);
+			if (auto summary = Pyramid_())
+			{
+				vector_type mins(dimension_);
+				summary->Query(Data_(), 0, summary->GetCount(), mins.data(), maxs.data());
+				return maxs;
+			}
+
+			bool first = true;
+			ForEachSample_([&](const value_type* p)
+			{
+				for (auto j = 0; j < dimension_; ++j)
+				{
+					if (first || p[j] > maxs[j])
+					{
+						maxs[j] = p[j];
+					}
+				}
+				first = false;
+			});
 
 			return maxs;
 		}
 
-		vector_type CalcMin() const
+		vector_type CalcMin() const
+		{
+			if (GetSampleCount() < 1)
+			{
+				return vector_type(dimension_, 0.0);
+			}
+			if (chart_type_ == chart::Heatmap)
+			{
+				vector_type mins;
+				vector_type maxs;
+				GridBounds_(mins, maxs);
+				return mins;
+			}
+
+			vector_type mins(dimension_);
+			if (auto summary = Pyramid_())
+			{
+				vector_type maxs(dimension_);
+				summary->Query(Data_(), 0, summary->GetCount(), mins.data(), maxs.data());
+				return mins;
+			}
+
+			bool first = true;
+			ForEachSample_([&](const value_type* p)
+			{
+				for (auto j = 0; j < dimension_; ++j)
+				{
+					if (first || p[j] < mins[j])
+					{
+						mins[j] = p[j];
+					}
+				}
+				first = false;
+			});
+
+			return mins;
+		}
+
+		//! CalcMin and CalcMax in one pass (one cv::minMaxLoc for a heatmap)
+		void CalcBounds(vector_type& mins, vector_type& maxs) const
+		{
+			mins.assign(dimension_, 0.0);
+			maxs.assign(dimension_, 0.0);
+			if (GetSampleCount() < 1)
+			{
+				return;
+			}
+			if (chart_type_ == chart::Heatmap)
+			{
+				GridBounds_(mins, maxs);
+				return;
+			}
+			if (auto summary = Pyramid_())
+			{
+				summary->Query(Data_(), 0, summary->GetCount(), mins.data(), maxs.data());
+				return;
+			}
+
+			bool first = true;
+			ForEachSample_([&](const value_type* p)
+			{
+				for (auto j = 0; j < dimension_; ++j)
+				{
+					if (first || p[j] < mins[j])
+					{
+						mins[j] = p[j];
+					}
+					if (first || p[j] > maxs[j])
+					{
+						maxs[j] = p[j];
+					}
+				}
+				first = false;
+			});
+		}
+
+		//! min/max of the samples with x in [x0, x1] (sample numbers for dimension 1), false if
+		//! there are none. O(log n) with a pyramid when x is sorted, a scan otherwise
+		bool CalcRange(double x0, double x1, vector_type& mins, vector_type& maxs) const
+		{
+			mins.assign(dimension_, DBL_MAX);
+			maxs.assign(dimension_, -DBL_MAX);
+			if (dimension_ < 1 || !(x0 <= x1))
+			{
+				return false;
+			}
+			if (chart_type_ == chart::Heatmap)
+			{
+				//! the rows are not cut by x, the whole grid
+				return GetSampleCount() > 0 && GridBounds_(mins, maxs) && mins[0] <= x1 && maxs[0] >= x0;
+			}
+
+			size_t begin = 0;
+			size_t end = 0;
+			if (dimension_ == 1 ? !filter_inf_nan_ : VisibleRange_(x0, x1, begin, end))
+			{
+				//! the exact range, without the neighbours VisibleRange_ adds
+				auto count = Size_() / dimension_;
+				auto data = Data_();
+				if (dimension_ == 1)
+				{
+					begin = (size_t)std::min<double>(count, std::max(0.0, std::ceil(x0) - 1));
+					end = (size_t)std::min<double>(count, std::max(0.0, std::floor(x1)));
+				}
+				else
+				{
+					while (begin < end && data[begin * dimension_] < x0)
+					{
+						++begin;
+					}
+					while (end > begin && data[(end - 1) * dimension_] > x1)
+					{
+						--end;
+					}
+				}
+
+				if (auto summary = Pyramid_())
+				{
+					return summary->Query(data, begin, end, mins.data(), maxs.data());
+				}
+				bool found = false;
+				ForEachSampleIn_(begin, end, [&](const value_type* p)
+				{
+					found = true;
+					for (auto j = 0; j < dimension_; ++j)
+					{
+						mins[j] = std::min(mins[j], p[j]);
+						maxs[j] = std::max(maxs[j], p[j]);
+					}
+				});
+				return found;
+			}
+
+			bool found = false;
+			size_t i = 0;
+			ForEachSample_([&](const value_type* p)
+			{
+				auto x = dimension_ == 1 ? (double)++i : p[0];
+				if (x < x0 || x > x1)
+				{
+					return;
+				}
+				found = true;
+				for (auto j = 0; j < dimension_; ++j)
+				{
+					mins[j] = std::min(mins[j], p[j]);
+					maxs[j] = std::max(maxs[j], p[j]);
+				}
+			});
+			return found;
+		}
+
+		//! keep a min/max pyramid (see pyramid::MinMax) next to the values: CalcMin, CalcMax,
+		//! CalcRange and zoomed out Line/Trends rendering then cost O(log n) per query/pixel
+		//! column instead of a scan. it is maintained lazily and costs ~n/4 bytes per dimension
+		Series& EnablePyramid(bool enable = true)
+		{
+			if (enable_pyramid_ != enable)
+			{
+				enable_pyramid_ = enable;
+				pyramid_.Reset();
+				pyramid_epoch_ = epoch_ - 1;
+			}
+			return *this;
+		}
+
+		bool HasPyramid() const
+		{
+			return enable_pyramid_;
+		}
+
+		//! heap bytes held by the samples and the pyramid, mapped (SetMapped) files are
+		//! page cache and a heatmap grid belongs to the caller, neither is counted
+		size_t GetMemory() const
+		{
+			return values_.capacity() * sizeof(value_type) + pyramid_.GetMemory();
+		}
+
+		//! quality::Draft strides through large series and leaves the value labels out
+		void Draw(cv::Mat& target, int index, int division,
+			double x_min, double /*x_max*/, double y_min, double y_max, double z_min, double z_max,
+			double px_start, double py_start, double px_delta, double py_delta,
+			quality::Type quality = quality::Full)
+		{
+			if (GetSampleCount() < 1)
+			{
+				dirty_ = false;
+				return;
+			}
+
+			if (!dirty_)
+			{
+				return;
+			}
+
+			auto cr = render_color_.ToScalar();
+			bool draft = quality == quality::Draft;
+			int line_type = draft ? cv::LINE_8 : cv::LINE_AA;
+
+			switch (chart_type_)
+			{
+			case chart::Bar:
+			{
+				auto x_0 = px_start + px_delta * index / (division + 1);
+				auto py_0 = py_delta > 10 ? 0.2 * py_delta : 2;
+				DrawBars_(target, Size_() / dimension_, x_0, px_delta, px_delta / (division + 1), y_min, py_delta, py_0, draft);
+			}
+			break;
+			case chart::Histogram:
+			{
+				//! (left edge, count) per bin, the last sample only closes the range.
+				//! adjacent bins keep a 1 px gap when there is room
+				auto data = Data_();
+				size_t count = Size_() / dimension_;
+				if (count >= 2)
+				{
+					auto spacing = (data[2] - data[0]) * px_delta;
+					auto x_0 = px_start + (data[0] - x_min) * px_delta;
+					DrawBars_(target, count - 1, x_0, spacing, spacing > 3 ? spacing - 1 : spacing, y_min, py_delta, 0, draft);
+				}
+			}
+			break;
+			case chart::Trends:
+			{
+				auto py_0 = py_delta > 10 ? 0.2 * py_delta : 2;
+				auto x_0 = px_start + 0.5 * division * px_delta / (division + 1.1);
+				int h = target.rows;
+				auto y_of = [&](value_type v) { return h - (int)((v > y_min) ? (v - y_min) * py_delta : py_0); };
+
+				//! samples are at x = 1, 2, ..., only the ones that land on the target are visited
+				size_t count = Size_() / dimension_;
+				auto i_of = [&](double x) { return (x - x_0) / px_delta + x_min - 1; };
+				auto begin = (size_t)std::min<double>(count, std::max(0.0, std::floor(i_of(0)) - 1));
+				auto end = (size_t)std::min<double>(count, std::max(0.0, std::ceil(i_of(target.cols)) + 2));
+				bool lod = (end - begin) > 2 * (size_t)target.cols;
+				std::vector<cv::Point> pts;
+				Lod_ decimator(pts, lod);
+				std::vector<std::pair<cv::Point, value_type>> labels;
+				auto summary = lod && !filter_inf_nan_ ? Pyramid_() : nullptr;
+				if (summary)
+				{
+					//! column c holds the samples up to i_of(c + 0.5)
+					Envelope_(*summary, begin, end, target.cols,
+						[&](size_t i, const value_type*) { return ToPixel_(x_0 + (i + 1 - x_min) * px_delta); },
+						[&](int c) { return (size_t)std::max(0.0, std::ceil(i_of(c + 0.5))); },
+						y_of, pts);
+				}
+				else
+				{
+					auto trend = [&](auto labeled)
+					{
+						ForEachOrdinal_(begin, end, [&](size_t i, const value_type* p)
+						{
+							auto x = ToPixel_(x_0 + (i + 1 - x_min) * px_delta);
+							auto y = y_of(*p);
+							decimator.Add(x, y);
+							if constexpr (decltype(labeled)::value)
+							{
+								labels.push_back({ { x,y }, *p });
+							}
+						}, DraftStep_(quality, begin, end, target.cols, 4));
+					};
+					if (!lod && !draft && marker_type_ != marker::None)
+					{
+						trend(std::true_type());
+					}
+					else
+					{
+						trend(std::false_type());
+					}
+					decimator.Flush();
+				}
+				int r = (marker_size_.width + marker_size_.height);
+				r = (r > 2 && r < 32) ? r : 4;
+				if (draft)
+				{
+					cv::polylines(target, pts, false, cr, 1, line_type);
+				}
+				else
+				{
+					raster::Polylines(target, pts, cr);
+				}
+
+				if (!labels.empty())
+				{
+					DrawMarkers_(target, pts, marker_type_, render_color_.Cut(64), r, 2);
+
+					auto cr1 = render_color_.Cut(90).ToScalar();
+					int fbase;
+					auto fface = cv::FONT_HERSHEY_SIMPLEX;
+					auto fscale = 0.8;
+					cv::Size fsize;
+					for (auto& label : labels)
+					{
+						char szText[16] = { 0 };
+						snprintf(szText, sizeof(szText), "%g", label.second);
+						fsize = cv::getTextSize(szText, fface, fscale, 1, &fbase);
+						cv::putText(target, szText, { label.first.x - fsize.width / 2,label.first.y - fbase }, fface, fscale, cr1, 1, cv::LINE_AA);
+					}
+				}
+			}
+			break;
+			case chart::Line:
+			case chart::Scatter:
+			{
+				int h = target.rows;
+				int w = target.cols;
+				size_t begin = 0;
+				size_t end = 0;
+				//! x range of the whole target (the plot area plus its padding)
+				auto x_of = [&](double x) { return (x - px_start) / px_delta + x_min; };
+				bool sorted = VisibleRange_(x_of(0), x_of(w), begin, end);
+				//! per pixel column min/max when there are more samples than pixels
+				bool lod = sorted && (end - begin) > 4 * (size_t)w;
+				std::vector<cv::Point> pts;
+				Lod_ decimator(pts, lod && chart_type_ == chart::Line);
+				auto summary = lod && chart_type_ == chart::Line && !filter_inf_nan_ ? Pyramid_() : nullptr;
+				if (summary)
+				{
+					//! column c holds the samples with x below x_of(c + 0.5)
+					auto data = Data_();
+					Envelope_(*summary, begin, end, w,
+						[&](size_t, const value_type* p) { return ToPixel_(px_start + (p[0] - x_min) * px_delta); },
+						[&](int c)
+						{
+							auto bound = x_of(c + 0.5);
+							auto lo = begin;
+							auto hi = end;
+							while (lo < hi)
+							{
+								auto mid = lo + (hi - lo) / 2;
+								if (data[mid * dimension_] < bound)
+								{
+									lo = mid + 1;
+								}
+								else
+								{
+									hi = mid;
+								}
+							}
+							return lo;
+						},
+						[&](value_type v) { return h - ToPixel_(py_start + (v - y_min) * py_delta); },
+						pts);
+					begin = end;
+				}
+				std::vector<byte> covered;
+				if (chart_type_ == chart::Scatter && (end - begin) > (size_t)w)
+				{
+					covered.resize((size_t)w * h + 1); //! the last cell takes the points outside
+				}
+				bool pending = false;
+				cv::Point previous;
+				if (!sorted && end - begin == 1)
+				{
+					sorted = true;
+				}
+				//! draft: ~4 samples per column of a line, a sixteenth of the pixels for a scatter
+				auto step = chart_type_ == chart::Scatter
+					? DraftStep_(quality, begin, end, (size_t)w * h / 16, 1)
+					: DraftStep_(quality, begin, end, w, 4);
+				auto to_point = [&](const value_type* p)
+				{
+					return cv::Point(ToPixel_(px_start + (p[0] - x_min) * px_delta), h - ToPixel_(py_start + (p[1] - y_min) * py_delta));
+				};
+				//! one kernel per chart (and scatter dedup), chosen here so the sample loop does not branch on them
+				if (chart_type_ == chart::Scatter)
+				{
+					//! branch free: every point is stored, the count only moves past the kept ones
+					auto scatter = [&](auto dedup)
+					{
+						size_t count = pts.size();
+						ForEachSampleIn_(begin, end, [&](const value_type* p)
+						{
+							auto pt = to_point(p);
+							bool keep = (unsigned)pt.x < (unsigned)w && (unsigned)pt.y < (unsigned)h;
+							if constexpr (decltype(dedup)::value)
+							{
+								auto& c = covered[keep ? (size_t)pt.y * w + pt.x : (size_t)w * h];
+								keep = keep && c == 0;
+								c = 1;
+							}
+							if (count == pts.size())
+							{
+								pts.resize(2 * count + 64);
+							}
+							pts[count] = pt;
+							count += keep;
+						}, step);
+						pts.resize(count);
+					};
+					if (covered.empty())
+					{
+						scatter(std::false_type());
+					}
+					else
+					{
+						scatter(std::true_type());
+					}
+				}
+				else if (sorted)
+				{
+					ForEachSampleIn_(begin, end, [&](const value_type* p)
+					{
+						auto pt = to_point(p);
+						decimator.Add(pt.x, pt.y);
+					}, step);
+				}
+				else
+				{
+					//! unsorted: keep the segments whose bounds touch the view, (INT_MIN, INT_MIN) splits runs
+					ForEachSampleIn_(begin, end, [&](const value_type* p)
+					{
+						auto pt = to_point(p);
+						if (pending && !(std::max(previous.x, pt.x) < 0 || std::min(previous.x, pt.x) >= w
+							|| std::max(previous.y, pt.y) < 0 || std::min(previous.y, pt.y) >= h))
+						{
+							if (pts.empty() || pts.back() != previous)
+							{
+								if (!pts.empty())
+								{
+									pts.push_back({ INT_MIN,INT_MIN });
+								}
+								pts.push_back(previous);
+							}
+							pts.push_back(pt);
+						}
+						previous = pt;
+						pending = true;
+					}, step);
+				}
+				decimator.Flush();
+				int r = (marker_size_.width + marker_size_.height);
+				r = (r > 2 && r < 32) ? r : 4;
+
+				if (/*chart_type_ == chart::Trends || */chart_type_ == chart::Line)
+				{
+					if (!lod && marker_type_ != marker::None)
+					{
+						std::vector<cv::Point> markers;
+						std::copy_if(pts.begin(), pts.end(), std::back_inserter(markers), [](const cv::Point& pt) { return pt.x != INT_MIN; });
+						DrawMarkers_(target, markers, marker_type_, render_color_.Cut(64), r, 2, line_type);
+					}
+					if (!draft)
+					{
+						raster::Polylines(target, pts, cr);
+					}
+					else
+					{
+						std::vector<cv::Point> run;
+						for (auto& pt : pts)
+						{
+							if (pt.x == INT_MIN)
+							{
+								cv::polylines(target, run, false, cr, 1, line_type);
+								run.clear();
+							}
+							else
+							{
+								run.push_back(pt);
+							}
+						}
+						cv::polylines(target, run, false, cr, 1, line_type);
+					}
+				}
+				else if (chart_type_ == chart::Scatter)
+				{
+					DrawMarkers_(target, pts, marker_type_, render_color_, r, 2, line_type);
+				}
+			}
+			break;
+			case chart::Elevation:
+			{
+				int h = target.rows;
+				int w = target.cols;
+				auto block_width = (int)(px_delta);
+				auto block_height = (int)(py_delta);
+				double factor = z_max > z_min ? 1.0 / (z_max - z_min) : 0;
+				cv::Size fsize;
+				auto fface = cv::FONT_HERSHEY_COMPLEX_SMALL;
+				int fbase;
+
+				//! blocks outside the view are skipped
+				ForEachSample_([&](const value_type* p)
+				{
+					auto x = ToPixel_(px_start + (p[0] - x_min) * px_delta);
+					auto y = h - ToPixel_(py_start + (p[1] - y_min) * py_delta);
+					if (x + block_width / 2 < 0 || x - block_width / 2 >= w || y + block_height / 2 < 0 || y - block_height / 2 >= h)
+					{
+						return;
+					}
+					auto color = factor > 0 ? render_color_.Linear((p[2] - z_min) * factor) : color::Transparent;
+					cv::Rect rect({ x - block_width / 2 + 1,y - block_height / 2 + 1,block_width - 2,block_height - 2 });
+					cv::rectangle(target, rect, color.ToScalar(), -1);
+					if (factor > 0 && !draft)
+					{
+						char sz[32] = { 0 };
+						snprintf(sz, sizeof(sz), "%g", p[2]);
+						fsize = cv::getTextSize(sz, fface, 1.0, 1, &fbase);
+						cv::putText(target, sz, { x - fsize.width / 2,y + fsize.height / 2 }, fface, 1.0, color.Reverse().ToScalar(), 1, cv::LINE_AA);
+					}
+				});
+			}
+			break;
+			case chart::Heatmap:
+			{
+				//! grid edges on the target, rows top down
+				int h = target.rows;
+				double left = px_start + (grid_extent_[0] - x_min) * px_delta;
+				double right = px_start + (grid_extent_[1] - x_min) * px_delta;
+				double top = h - (py_start + (grid_extent_[3] - y_min) * py_delta);
+				double bottom = h - (py_start + (grid_extent_[2] - y_min) * py_delta);
+				DrawGrid_(target, left, right, top, bottom, z_min, z_max);
+			}
+			break;
+			default:
+				break;
+			}
+		}
+
+		void Dump(const std::string filename, dump::Encoding encoding = dump::Raw)
+		{
+			DumpMeta_(filename, encoding, 0);
+			journal_ = journal::State(); //! the metadata no longer refers to a journal
+		}
+
+		//! persist the series incrementally: the first call (and every compaction)
+		//! writes a snapshot like Dump + DumpBinary, later calls only append the new
+		//! values and style changes to filename + ".jnl". Load replays both
+		Series& Checkpoint(const std::string filename)
+		{
+			Materialize_();
+			auto style = Style_();
+			bool compact = journal_.journal_bytes > journal::COMPACT_MIN_BYTES
+				&& journal_.journal_bytes > journal_.snapshot_bytes;
+			bool snapshot = journal_.filename != filename
+				|| journal_.epoch != epoch_
+				|| values_.size() < journal_.committed
+				|| journal_.records >= journal::COMPACT_MAX_RECORDS
+				|| chart_type_ == chart::Histogram //! counts change in place
+				|| compact
+				|| (journal_.style.size() == style.size() && Dimension_(journal_.style) != dimension_);
+
+			if (snapshot)
+			{
+				//! everything goes to temp files first, then is committed .bin -> meta -> journal
+				//! by renames. until the meta is replaced the old snapshot and journal stay
+				//! loadable, after it the old journal no longer matches the id and is ignored
+				auto id = journal::NewId();
+				DumpBinary(filename + ".bin.tmp");
+				DumpMeta_(filename + ".tmp", dump::Raw, id);
+				journal::FileHeader header = {};
+				memcpy(header.magic, journal::MAGIC, sizeof(journal::MAGIC));
+				header.version = journal::VERSION;
+				header.id = id;
+				FILE* fp = util::OpenFile(filename + ".jnl.tmp", "wb");
+				bool ok = fp != nullptr && fwrite(&header, sizeof(header), 1, fp) == 1;
+				ok = (fp != nullptr && fclose(fp) == 0) && ok;
+				if (!ok
+					|| !util::ReplaceFile(filename + ".bin.tmp", filename + ".bin")
+					|| !util::ReplaceFile(filename + ".tmp", filename)
+					|| !util::ReplaceFile(filename + ".jnl.tmp", filename + ".jnl"))
+				{
+					journal_ = journal::State();
+					throw std::runtime_error("failed to write series snapshot");
+				}
+
+				journal_ = journal::State();
+				journal_.filename = filename;
+				journal_.id = id;
+				journal_.epoch = epoch_;
+				journal_.committed = values_.size();
+				journal_.snapshot_bytes = values_.size() * sizeof(value_type);
+				journal_.style = style;
+				return *this;
+			}
+
+			if (style == journal_.style && values_.size() == journal_.committed)
+			{
+				return *this;
+			}
+
+			FILE* fp = util::OpenFile(filename + ".jnl", "ab");
+			if (fp == nullptr)
+			{
+				throw std::runtime_error("failed to open series journal");
+			}
+			bool ok = true;
+			if (style != journal_.style)
+			{
+				ok = journal::WriteRecord(fp, journal::Style, style.data(), style.size());
+				journal_.journal_bytes += sizeof(journal::RecordHeader) + style.size();
+				journal_.style = style;
+				++journal_.records;
+			}
+			if (ok && values_.size() > journal_.committed)
+			{
+				auto count = values_.size() - journal_.committed;
+				ok = journal::WriteRecord(fp, journal::Append, values_.data() + journal_.committed, count * sizeof(value_type));
+				journal_.journal_bytes += sizeof(journal::RecordHeader) + count * sizeof(value_type);
+				journal_.committed = values_.size();
+				++journal_.records;
+			}
+			ok = (fclose(fp) == 0) && ok;
+			if (!ok)
+			{
+				journal_ = journal::State(); //! start over with a snapshot next time
+				throw std::runtime_error("failed to append to series journal");
+			}
+			return *this;
+		}
+
+		//! replay the journal written by Checkpoint on top of the loaded snapshot
+		Series& ReplayJournal(const std::string filename, const bool filterInfNaN)
+		{
+			FILE* fp = util::OpenFile(filename, "rb");
+			if (fp == nullptr)
+			{
+				return *this;
+			}
+
+			journal::FileHeader header;
+			if (fread(&header, sizeof(header), 1, fp) != 1
+				|| memcmp(header.magic, journal::MAGIC, sizeof(journal::MAGIC)) != 0
+				|| header.version != journal::VERSION
+				|| header.id != stored_journal_)
+			{
+				fclose(fp);
+				return *this;
+			}
+
+			Materialize_();
+			journal::RecordHeader record;
+			std::vector<byte> payload;
+			while (fread(&record, sizeof(record), 1, fp) == 1 && record.magic == journal::RECORD_MAGIC)
+			{
+				if (record.size > ((uint64_t)1 << 40))
+				{
+					break;
+				}
+				payload.resize((size_t)record.size);
+				if ((record.size > 0 && fread(payload.data(), 1, payload.size(), fp) != payload.size())
+					|| pack::Crc32(payload.data(), payload.size()) != record.checksum)
+				{
+					break; //! torn tail
+				}
+
+				if (record.type == journal::Append)
+				{
+					vector_type values(payload.size() / sizeof(value_type));
+					memcpy(values.data(), payload.data(), values.size() * sizeof(value_type));
+					if (filterInfNaN)
+					{
+						FilterInfNaN_(values);
+					}
+					values_.insert(values_.end(), values.begin(), values.end());
+				}
+				else if (record.type == journal::Style)
+				{
+					ApplyStyle_(payload);
+				}
+			}
+			fclose(fp);
+			dirty_ = true;
+
+			return *this;
+		}
+
+		//! true if the metadata read by Load() belongs to a journaled snapshot
+		bool HasJournal() const
+		{
+			return stored_journal_ != 0;
+		}
+
+	private:
+		void DumpMeta_(const std::string filename, dump::Encoding encoding, uint64_t journal)
+		{
+			FILE* fp = util::OpenFile(filename, "w");
+			if (fp)
+			{
+				fprintf(fp, "label=%s\n", label_.c_str());
+				fprintf(fp, "%d\n", chart_type_);
+				fprintf(fp, "%d\n", marker_type_);
+				fprintf(fp, "%d %d\n", marker_size_.width, marker_size_.height);
+				fprintf(fp, "%d\n", dimension_);
+				fprintf(fp, "%d\n", enable_legend_ ? 1 : 0);
+				auto vec4 = render_color_.ToVec4b(); //BGRA
+				fprintf(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
+				int n = GetSampleCount() * dimension_;
+				fprintf(fp, "\n%d\n", n);
+				if (encoding != dump::Raw)
+				{
+					fprintf(fp, "encoding=%d\n", encoding);
+				}
+				if (journal != 0)
+				{
+					fprintf(fp, "journal=%llu\n", (unsigned long long)journal);
+				}
+			}
+			fclose(fp);
+		}
+
+		std::vector<byte> Style_() const
+		{
+			pack::Buffer buffer;
+			buffer.PutInt(dimension_)
+				.PutInt(chart_type_)
+				.PutInt(marker_type_)
+				.PutInt(marker_size_.width)
+				.PutInt(marker_size_.height)
+				.PutInt(enable_legend_ ? 1 : 0)
+				.PutColor(render_color_);
+			return buffer.GetData();
+		}
+
+		static int Dimension_(const std::vector<byte>& style)
+		{
+			auto buffer = pack::Buffer(std::vector<byte>(style));
+			return buffer.GetInt();
+		}
+
+		void ApplyStyle_(const std::vector<byte>& style)
+		{
+			auto buffer = pack::Buffer(std::vector<byte>(style));
+			if (buffer.GetInt() != dimension_)
+			{
+				return;
+			}
+			chart_type_ = buffer.GetInt();
+			marker_type_ = buffer.GetInt();
+			marker_size_.width = buffer.GetInt();
+			marker_size_.height = buffer.GetInt();
+			enable_legend_ = buffer.GetInt() > 0;
+			auto color = buffer.GetColor();
+			render_color_ = color;
+		}
+
+	public:
+
+		void DumpText(const std::string filename)
+		{
+			FILE* fp = util::OpenFile(filename, "wb");
+			if (fp)
+			{
+				{
+					text::Writer writer(fp);
+					ForEachSample_([&](const value_type* p)
+					{
+						for (int j = 0; j < dimension_; ++j)
+						{
+							writer.Put(p[j]).Put(' ');
+						}
+						writer.Put('\n');
+					});
+					writer.Put('\n');
+				}
+				fclose(fp);
+			}
+		}
+
+		//! written to a temp file and renamed over filename, so a series mapped from
+		//! filename (LoadBinary) keeps reading the old file until the rename
+		void DumpBinary(const std::string filename)
+		{
+			auto temp = filename + ".tmp";
+			FILE* fp = util::OpenFile(temp, "wb");
+			if (fp == nullptr)
+			{
+				throw std::runtime_error("failed to dump series");
+			}
+			bool ok = true;
+			if (Size_() > 0)
+			{
+				if (filter_inf_nan_)
+				{
+					ForEachSample_([&](const value_type* p) { ok = fwrite(p, sizeof(value_type), dimension_, fp) == (size_t)dimension_ && ok; });
+				}
+				else
+				{
+					ok = fwrite(Data_(), sizeof(value_type), Size_(), fp) == Size_();
+				}
+			}
+			ok = fclose(fp) == 0 && ok;
+			bool replaced = ok && util::ReplaceFile(temp, filename);
+			if (ok && !replaced && mapping_)
+			{
+				//! a mapped file cannot be replaced on Windows, drop the mapping and retry
+				Materialize_();
+				replaced = util::ReplaceFile(temp, filename);
+			}
+			if (!replaced)
+			{
+				remove(temp.c_str());
+				throw std::runtime_error("failed to dump series");
+			}
+		}
+
+		void DumpCompressed(const std::string filename)
+		{
+			FILE* fp = util::OpenFile(filename, "wb");
+			if (fp)
+			{
+				std::vector<byte> data;
+				if (filter_inf_nan_)
+				{
+					auto values = CollectVisible_();
+					data = gorilla::Encode(values.data(), values.size() / dimension_, dimension_);
+				}
+				else
+				{
+					data = gorilla::Encode(Data_(), Size_() / std::max(dimension_, 1), dimension_);
+				}
+				fwrite(data.data(), 1, data.size(), fp);
+				fclose(fp);
+			}
+		}
+
+		Series& Load(const std::string filename)
+		{
+			FILE* fp = util::OpenFile(filename, "r");
+			if (fp == nullptr)
+			{
+				throw std::runtime_error("failed to load series");
+			}
+
+			std::string line;
+			util::ReadLine(fp, line);
+			label_ = line.substr(std::min<size_t>(6, line.size())); //! cut "label="
+			util::ScanFile(fp, "%d\n", &chart_type_);
+			util::ScanFile(fp, "%d\n", &marker_type_);
+			util::ScanFile(fp, "%d %d\n", &(marker_size_.width), &(marker_size_.height));
+			util::ScanFile(fp, "%d\n", &dimension_);
+			int enable;
+			util::ScanFile(fp, "%d\n", &enable);
+			enable_legend_ = enable > 0;
+			int b, g, r, a;
+			util::ScanFile(fp, "%d %d %d %d\n", &b, &g, &r, &a);
+			auto color = Color(r, g, b, a);
+			render_color_ = color;
+			int n;
+			util::ScanFile(fp, "%d\n", &n);
+			Unmap_();
+			values_.clear();
+			stored_count_ = n > 0 ? n : 0;
+			stored_encoding_ = dump::Raw;
+			util::ScanFile(fp, "encoding=%d\n", &stored_encoding_);
+			unsigned long long journal = 0;
+			util::ScanFile(fp, "journal=%llu\n", &journal);
+			stored_journal_ = journal;
+			dirty_ = true;
+
+			fclose(fp);
+
+			return *this;
+		}
+
+		Series& LoadText(const std::string filename, const bool filterInfNaN)
+		{
+			FILE* fp = util::OpenFile(filename, "rb");
+			if (fp == nullptr)
+			{
+				throw std::runtime_error("failed to load series");
+			}
+			Unmap_();
+			values_.resize(stored_count_);
+			if (values_.size() > 0)
+			{
+				text::Reader reader(fp);
+				size_t n = 0;
+				while (n < values_.size() && reader.Next(values_[n]))
+				{
+					++n;
+				}
+				values_.resize(n);
+				if (filterInfNaN)
+				{
+					FilterInfNaN_(values_);
+				}
+			}
+			dirty_ = true;
+
+			fclose(fp);
+
+			return *this;
+		}
+
+		Series& LoadCompressed(const std::string filename, const bool filterInfNaN)
+		{
+			util::MappedFile file(filename);
+			Unmap_();
+			vector_type values;
+			if (file.GetSize() > 0 && gorilla::Decode(file.GetData(), file.GetSize(), values) != dimension_)
+			{
+				throw std::runtime_error("series dimension mismatch");
+			}
+			if (values.size() != stored_count_)
+			{
+				throw std::runtime_error("series count mismatch");
+			}
+			values_ = std::move(values);
+			if (filterInfNaN)
+			{
+				FilterInfNaN_(values_);
+			}
+			dirty_ = true;
+
+			return *this;
+		}
+
+		//! encoding of the values written next to the metadata read by Load()
+		dump::Encoding GetStoredEncoding() const
+		{
+			return stored_encoding_;
+		}
+
+		//! with mapped=true the values stay in the mapped file pages, they are neither
+		//! copied nor filtered here: Inf/NaN samples are skipped lazily while drawing
+		Series& LoadBinary(const std::string filename, const bool filterInfNaN, const bool mapped = false)
+		{
+			if (mapped)
+			{
+				auto file = std::make_shared<util::MappedFile>(filename);
+				auto count = std::min(stored_count_, file->GetSize() / sizeof(value_type));
+				Map_(file, (const value_type*)file->GetData(), count, filterInfNaN);
+				dirty_ = true;
+				return *this;
+			}
+
+			FILE* fp = util::OpenFile(filename, "rb");
+			if (fp == nullptr)
+			{
+				throw std::runtime_error("failed to load series");
+			}
+
+			Unmap_();
+			values_.resize(stored_count_);
+			if (values_.size() > 0)
+			{
+				fread(values_.data(), sizeof(value_type), values_.size(), fp);
+				if (filterInfNaN)
+				{
+					FilterInfNaN_(values_);
+				}
+			}
+			dirty_ = true;
+
+			fclose(fp);
+
+			return *this;
+		}
+
+		void DumpPack(pack::Writer& writer, uint32_t view, uint32_t series) const
+		{
+			pack::Buffer buffer;
+			buffer.PutString(label_)
+				.PutInt(chart_type_)
+				.PutInt(marker_type_)
+				.PutInt(marker_size_.width)
+				.PutInt(marker_size_.height)
+				.PutInt(dimension_)
+				.PutInt(enable_legend_ ? 1 : 0)
+				.PutColor(render_color_)
+				.PutUInt64((uint64_t)GetSampleCount() * dimension_);
+			writer.Write(pack::block::Series, view, series, buffer);
+			vector_type values;
+			if (filter_inf_nan_)
+			{
+				values = CollectVisible_();
+			}
+			auto data = filter_inf_nan_ ? values.data() : Data_();
+			auto size = filter_inf_nan_ ? values.size() : Size_();
+			if (writer.GetFlags() & pack::Compress)
+			{
+				auto encoded = gorilla::Encode(data, size / std::max(dimension_, 1), dimension_);
+				writer.Write(pack::block::Data, view, series, encoded.data(), encoded.size(), pack::Compress);
+			}
+			else
+			{
+				writer.Write(pack::block::Data, view, series, data, size * sizeof(value_type));
+			}
+		}
+
+		//! load the metadata (pack::block::Series) or the values (pack::block::Data) of this series
+		Series& LoadPack(pack::Reader& reader, const pack::BlockHeader& header, const bool filterInfNaN)
+		{
+			if (header.kind == pack::block::Series)
+			{
+				auto buffer = reader.ReadBuffer(header);
+				label_ = buffer.GetString();
+				chart_type_ = buffer.GetInt();
+				marker_type_ = buffer.GetInt();
+				marker_size_.width = buffer.GetInt();
+				marker_size_.height = buffer.GetInt();
+				dimension_ = buffer.GetInt();
+				enable_legend_ = buffer.GetInt() > 0;
+				auto color = buffer.GetColor();
+				render_color_ = color;
+				Unmap_();
+				values_.clear();
+				auto count = buffer.GetUInt64();
+				if (dimension_ <= 0 || count % dimension_ != 0)
+				{
+					throw std::runtime_error("corrupted pack block");
+				}
+				stored_count_ = (size_t)count;
+			}
+			else if (header.kind == pack::block::Data && (header.flags & pack::Compress))
+			{
+				Unmap_();
+				std::vector<byte> encoded;
+				const byte* data;
+				if (reader.IsMapped())
+				{
+					data = reader.Map(header);
+				}
+				else
+				{
+					encoded.resize((size_t)header.size);
+					reader.Read(header, encoded.data());
+					data = encoded.data();
+				}
+				if (header.size > 0)
+				{
+					gorilla::Decode(data, (size_t)header.size, values_);
+				}
+				if (values_.size() != stored_count_)
+				{
+					throw std::runtime_error("corrupted pack block");
+				}
+				if (filterInfNaN)
+				{
+					FilterInfNaN_(values_);
+				}
+			}
+			else if (header.kind == pack::block::Data)
+			{
+				if (header.size % sizeof(value_type) != 0 || header.size / sizeof(value_type) != stored_count_)
+				{
+					throw std::runtime_error("corrupted pack block");
+				}
+				if (reader.IsMapped())
+				{
+					Map_(reader.GetMapping(), (const value_type*)reader.Map(header), stored_count_, filterInfNaN);
+				}
+				else
+				{
+					values_.resize(stored_count_);
+					reader.Read(header, values_.data());
+					if (filterInfNaN)
+					{
+						FilterInfNaN_(values_);
+					}
+				}
+			}
+			dirty_ = true;
+
+			return *this;
+		}
+
+	public:
+		static Series Convert(Series& source, chart::Type chartType)
+		{
+			if (source.GetDimension() != 1 || chart::GetDimension(chartType) != 2)
+			{
+				throw std::runtime_error("conversion not supported");
+			}
+
+			return Series(source, chartType);
+		}
+
+	private:
+		Series& SetBins_(histogram::Bins bins)
+		{
+			Clear();
+			bins_ = bins;
+			return *this;
+		}
+
+		//! values per sample pushed by producers, a histogram takes raw values
+		int InputDimension_() const
+		{
+			return chart_type_ == chart::Histogram ? 1 : dimension_;
+		}
+
+		const value_type* Data_() const
+		{
+			return mapping_ ? mapped_ : values_.data();
+		}
+
+		size_t Size_() const
+		{
+			return mapping_ ? mapped_count_ : values_.size();
+		}
+
+		//! visit every sample (dimension_ values), skipping non-finite ones if filtering lazily
+		template<typename F>
+		void ForEachSample_(F f) const
+		{
+			if (dimension_ < 1)
+			{
+				return;
+			}
+
+			ForEachSampleIn_(0, Size_() / dimension_, f);
+		}
+
+		//! same for the stored samples [begin, end)
+		template<typename F>
+		void ForEachSampleIn_(size_t begin, size_t end, F f, size_t step = 1) const
+		{
+			//! the loop specialized on the dimension and the Inf/NaN filter, by dimension * 2 + filter
+			typedef void (Series::*Loop)(size_t, size_t, F&, size_t) const;
+			static const Loop LOOPS[] =
+			{
+				&Series::SampleLoop_<1, false, F>, &Series::SampleLoop_<1, true, F>,
+				&Series::SampleLoop_<2, false, F>, &Series::SampleLoop_<2, true, F>,
+				&Series::SampleLoop_<3, false, F>, &Series::SampleLoop_<3, true, F>,
+			};
+			if (dimension_ >= 1 && dimension_ <= 3)
+			{
+				(this->*LOOPS[(dimension_ - 1) * 2 + (filter_inf_nan_ ? 1 : 0)])(begin, end, f, step);
+			}
+		}
+
+		template<int Dimension, bool Filter, typename F>
+		void SampleLoop_(size_t begin, size_t end, F& f, size_t step) const
+		{
+			auto data = Data_();
+			for (size_t i = begin * Dimension; i < end * Dimension; i += step * Dimension)
+			{
+				if constexpr (Filter)
+				{
+					bool finite = true;
+					for (int j = 0; j < Dimension; ++j)
+					{
+						finite = finite && std::isfinite(data[i + j]);
+					}
+					if (!finite)
+					{
+						continue;
+					}
+				}
+				f(data + i);
+			}
+		}
+
+		//! visit the samples whose position among the visible ones is in [begin, end),
+		//! f(position, sample). positions only differ from storage indices when filtering lazily.
+		//! step > 1 visits every step-th position only
+		template<typename F>
+		void ForEachOrdinal_(size_t begin, size_t end, F f, size_t step = 1) const
+		{
+			if (!filter_inf_nan_)
+			{
+				auto i = begin;
+				ForEachSampleIn_(begin, end, [&](const value_type* p) { f(i, p); i += step; }, step);
+				return;
+			}
+
+			size_t i = 0;
+			ForEachSample_([&](const value_type* p)
+			{
+				if (i >= begin && i < end && (i - begin) % step == 0)
+				{
+					f(i, p);
+				}
+				++i;
+			});
+		}
+
+		//! Draft stride: at most per_pixel samples of [begin, end) for each of pixels
+		static size_t DraftStep_(quality::Type quality, size_t begin, size_t end, size_t pixels, size_t per_pixel)
+		{
+			if (quality != quality::Draft || pixels == 0)
+			{
+				return 1;
+			}
+			return std::max<size_t>(1, (end - begin) / (pixels * per_pixel));
+		}
+
+		//! the pyramid brought up to date, nullptr when not enabled
+		const pyramid::MinMax* Pyramid_() const
+		{
+			if (!enable_pyramid_ || dimension_ < 1)
+			{
+				return nullptr;
+			}
+			if (pyramid_epoch_ != epoch_)
+			{
+				pyramid_.Reset();
+				pyramid_epoch_ = epoch_;
+			}
+			pyramid_.Update(Data_(), Size_() / dimension_, dimension_, filter_inf_nan_);
+			return &pyramid_;
+		}
+
+		//! true if x (the first value of each sample) never decreases, checked
+		//! incrementally while the series only grows
+		bool IsSortedX_() const
+		{
+			auto data = Data_();
+			auto count = dimension_ > 0 ? Size_() / dimension_ : 0;
+			if (data != sorted_data_ || count < sorted_count_)
+			{
+				sorted_data_ = data;
+				sorted_count_ = 0;
+				sorted_x_ = true;
+			}
+			for (auto i = std::max<size_t>(sorted_count_, 1); sorted_x_ && i < count; ++i)
+			{
+				sorted_x_ = data[i * dimension_] >= data[(i - 1) * dimension_];
+			}
+			sorted_count_ = count;
+			return sorted_x_;
+		}
+
+		//! stored samples with x in [x_min, x_max] plus one neighbour on each side, found
+		//! by binary search when x is sorted (return value). everything otherwise. Draw
+		//! passes the x under the first and last pixel column, not the view range
+		bool VisibleRange_(double x_min, double x_max, size_t& begin, size_t& end) const
 		{
-			auto count = values_.size();
-			if (count < dimension_)
+			auto count = dimension_ > 0 ? Size_() / dimension_ : 0;
+			begin = 0;
+			end = count;
+			if (dimension_ < 2 || !IsSortedX_())
 			{
-				return vector_type(dimension_, 0.0);
+				return dimension_ < 2;
+			}
+
+			auto data = Data_();
+			auto lower = [&](double x)
+			{
+				size_t lo = 0;
+				size_t hi = count;
+				while (lo < hi)
+				{
+					auto mid = lo + (hi - lo) / 2;
+					if (data[mid * dimension_] < x)
+					{
+						lo = mid + 1;
+					}
+					else
+					{
+						hi = mid;
+					}
+				}
+				return lo;
+			};
+			auto first = lower(x_min);
+			auto last = lower(std::nextafter(x_max, DBL_MAX));
+			begin = first > 0 ? first - 1 : 0;
+			end = std::min(count, last + 1);
+			return true;
+		}
+
+		//! pixel coordinate, clamped far outside the view so zoomed out-of-range samples stay drawable
+		static int ToPixel_(double v)
+		{
+			const double LIMIT = 1 << 24;
+			v = std::max(-LIMIT, std::min(LIMIT, v)) + 0.5;
+			int i = (int)v;
+			return i - (v < i); //! floor, without the libm call on targets lacking roundsd
+		}
+
+		//! polyline level of detail: per pixel column keep first, min, max and last point
+		//! (in sample order), which draws the same pixels as the full polyline
+		struct Lod_
+		{
+			std::vector<cv::Point>& pts;
+			bool enabled;
+			int column = INT_MIN;
+			cv::Point first;
+			cv::Point last;
+			cv::Point lo;
+			cv::Point hi;
+			size_t lo_at = 0;
+			size_t hi_at = 0;
+			size_t at = 0;
+
+			Lod_(std::vector<cv::Point>& points, bool enable) : pts(points), enabled(enable)
+			{
+				//
+			}
+
+			void Add(int x, int y)
+			{
+				if (!enabled)
+				{
+					pts.push_back({ x,y });
+					return;
+				}
+				if (x != column)
+				{
+					Flush();
+					column = x;
+					first = last = lo = hi = { x,y };
+					lo_at = hi_at = at;
+				}
+				else
+				{
+					last = { x,y };
+					if (y < lo.y)
+					{
+						lo = last;
+						lo_at = at;
+					}
+					if (y > hi.y)
+					{
+						hi = last;
+						hi_at = at;
+					}
+				}
+				++at;
+			}
+
+			void Flush()
+			{
+				if (!enabled || column == INT_MIN)
+				{
+					return;
+				}
+				Push_(first);
+				Push_(lo_at <= hi_at ? lo : hi);
+				Push_(lo_at <= hi_at ? hi : lo);
+				Push_(last);
+				column = INT_MIN;
+			}
+
+			void Push_(const cv::Point& pt)
+			{
+				if (pts.empty() || pts.back() != pt)
+				{
+					pts.push_back(pt);
+				}
+			}
+		};
+
+		//! the Lod_ output straight from the pyramid: per pixel column the first and last sample
+		//! plus the min/max of the last value (y), O(columns * log n). x_of(i, p) is the column of
+		//! sample i, next(c) the first sample right of column c. only for x-sorted, unfiltered values
+		template<typename X, typename N, typename Y>
+		void Envelope_(const pyramid::MinMax& summary, size_t begin, size_t end, int columns,
+			X x_of, N next, Y y_of, std::vector<cv::Point>& pts) const
+		{
+			if (begin >= end)
+			{
+				return;
 			}
 
+			auto data = Data_();
+			auto at = [&](size_t i) { return data + i * dimension_; };
+			auto push = [&](const cv::Point& pt)
+			{
+				if (pts.empty() || pts.back() != pt)
+				{
+					pts.push_back(pt);
+				}
+			};
+
+			//! samples left of column 0 (or right of the last one) share one off-target column
+			auto first = std::max(-1, x_of(begin, at(begin)));
+			auto last = std::min(columns, x_of(end - 1, at(end - 1)));
 			vector_type mins(dimension_);
-			for (auto j = 0; j < dimension_; ++j)
+			vector_type maxs(dimension_);
+			auto y = dimension_ - 1;
+			auto a = begin;
+			for (auto c = first; c <= last && a < end; ++c)
 			{
-				mins[j] = values_[j];
-				for (auto i = 0; i < count; i += dimension_)
+				auto b = c == last ? end : std::min(end, std::max(a, next(c)));
+				if (c != last)
 				{
-					if (values_[i + j] < mins[j])
+					//! next is computed in x, fix rounding so the split agrees with x_of
+					while (b < end && x_of(b, at(b)) <= c)
+					{
+						++b;
+					}
+					while (b > a && x_of(b - 1, at(b - 1)) > c)
 					{
-						mins[j] = values_[i + j];
+						--b;
 					}
 				}
+				if (b == a)
+				{
+					continue;
+				}
+				push({ x_of(a, at(a)), y_of(at(a)[y]) });
+				if (b - a > 2 && summary.Query(data, a, b, mins.data(), maxs.data()))
+				{
+					push({ c, y_of(mins[y]) });
+					push({ c, y_of(maxs[y]) });
+				}
+				push({ x_of(b - 1, at(b - 1)), y_of(at(b - 1)[y]) });
+				a = b;
 			}
+		}
 
-			return mins;
+		void Map_(std::shared_ptr<util::MappedFile> mapping, const value_type* data, size_t count, bool filterInfNaN)
+		{
+			vector_type().swap(values_);
+			mapping_ = mapping;
+			mapped_ = data;
+			mapped_count_ = count;
+			filter_inf_nan_ = filterInfNaN;
+			visible_count_ = -1;
+			++epoch_;
+			bins_.Invalidate();
 		}
 
-		void Draw(cv::Mat& target, int index, int division,
-			double x_min, double x_max, double y_min, double y_max, double z_min, double z_max,
-			double px_start, double py_start, double px_delta, double py_delta)
+		//! also marks the values as replaced, so the next Checkpoint writes a snapshot
+		//! and histogram bins take over the edges of the new values
+		void Unmap_()
 		{
-			if (values_.size() < dimension_)
+			mapping_.reset();
+			mapped_ = nullptr;
+			mapped_count_ = 0;
+			filter_inf_nan_ = false;
+			visible_count_ = -1;
+			++epoch_;
+			bins_.Invalidate();
+		}
+
+		vector_type CollectVisible_() const
+		{
+			vector_type values;
+			ForEachSample_([&](const value_type* p) { values.insert(values.end(), p, p + dimension_); });
+			return values;
+		}
+
+		//! copy mapped values into owned memory before they get modified
+		Series& Materialize_()
+		{
+			if (mapping_)
+			{
+				vector_type values;
+				values.reserve(mapped_count_);
+				ForEachSample_([&](const value_type* p) { values.insert(values.end(), p, p + dimension_); });
+				Unmap_();
+				values_ = std::move(values);
+			}
+			return *this;
+		}
+
+		//! drop every sample (dimension_ values) that holds an Inf or NaN
+		void FilterInfNaN_(vector_type& values) const
+		{
+			if (dimension_ < 1)
 			{
-				dirty_ = false;
 				return;
 			}
 
-			if (!dirty_)
+			size_t n = 0;
+			for (size_t i = 0; i + dimension_ <= values.size(); i += dimension_)
+			{
+				bool finite = true;
+				for (int j = 0; j < dimension_; ++j)
+				{
+					finite = finite && !std::isnan(values[i + j]) && !std::isinf(values[i + j]);
+				}
+				if (finite)
+				{
+					std::copy(values.begin() + i, values.begin() + i + dimension_, values.begin() + n);
+					n += dimension_;
+				}
+			}
+			values.resize(n);
+		}
+
+		void DrawMarkers_(cv::Mat target, const std::vector<cv::Point>& pts, marker::Type type, Color color, int size, int thickness, int line_type = cv::LINE_AA)
+		{
+			//! one kernel per marker, indexed by marker::Type
+			typedef void (*Kernel)(cv::Mat&, const std::vector<cv::Point>&, const cv::Scalar&, int, int, int);
+			static const Kernel KERNELS[] =
+			{
+				nullptr,
+				&Markers_<marker::Cross>,
+				&Markers_<marker::Plus>,
+				&Markers_<marker::Star>,
+				&Markers_<marker::Circle>,
+				&Markers_<marker::Square>,
+				&Markers_<marker::Diamond>,
+			};
+			if (type > marker::None && type <= marker::Diamond)
+			{
+				KERNELS[type](target, pts, color.ToScalar(), size, thickness, line_type);
+			}
+		}
+
+		template<marker::Type Type>
+		static void Markers_(cv::Mat& target, const std::vector<cv::Point>& pts, const cv::Scalar& cr, int size, int thickness, int line_type)
+		{
+			for (auto& pt : pts)
+			{
+				if constexpr (Type == marker::Circle)
+				{
+					cv::circle(target, pt, size / 2, cr, 2, cv::LINE_8);
+				}
+				else
+				{
+					cv::drawMarker(target, pt, cr, MarkerShape_(Type), size, thickness, line_type);
+				}
+			}
+		}
+
+		//! x, y extent and the cv::minMaxLoc z range of the grid, false if it is empty
+		bool GridBounds_(vector_type& mins, vector_type& maxs) const
+		{
+			if (grid_.empty())
+			{
+				return false;
+			}
+			mins = { std::min(grid_extent_[0], grid_extent_[1]), std::min(grid_extent_[2], grid_extent_[3]), 0 };
+			maxs = { std::max(grid_extent_[0], grid_extent_[1]), std::max(grid_extent_[2], grid_extent_[3]), 0 };
+			cv::minMaxLoc(grid_, &mins[2], &maxs[2]);
+			return true;
+		}
+
+		//! the grid stretched over [left, right) x [top, bottom) of target (CV_8UC4): the
+		//! nearest cell of each visible pixel, through a 256 entry ramp of the render color.
+		//! costs O(visible pixels) whatever the grid size, NaN cells are left out
+		void DrawGrid_(cv::Mat& target, double left, double right, double top, double bottom, double z_min, double z_max)
+		{
+			if (grid_.empty() || target.type() != CV_8UC4)
+			{
+				return;
+			}
+
+			//! source cell of every target column / row, -1 outside the grid
+			auto index = [](int pixels, double first, double last, int cells, std::vector<int>& out)
+			{
+				auto scale = cells / (last - first);
+				out.resize(pixels);
+				for (int i = 0; i < pixels; ++i)
+				{
+					auto k = std::floor((i + 0.5 - first) * scale);
+					out[i] = (k >= 0 && k < cells) ? (int)k : -1;
+				}
+			};
+			std::vector<int> columns;
+			std::vector<int> rows;
+			index(target.cols, left, right, grid_.cols, columns);
+			index(target.rows, top, bottom, grid_.rows, rows);
+			auto c0 = std::find_if(columns.begin(), columns.end(), [](int k) { return k >= 0; }) - columns.begin();
+			auto c1 = columns.rend() - std::find_if(columns.rbegin(), columns.rend(), [](int k) { return k >= 0; });
+			if (c0 >= c1)
 			{
 				return;
 			}
+			columns.erase(columns.begin() + c1, columns.end());
+			columns.erase(columns.begin(), columns.begin() + c0);
 
+			cv::Vec4b lut[256];
+			for (int i = 0; i < 256; ++i)
+			{
+				lut[i] = render_color_.Linear(i / 255.0).ToVec4b();
+			}
+			double scale = z_max > z_min ? 255 / (z_max - z_min) : 0;
+			switch (grid_.depth())
+			{
+			case CV_8U:
+				GridRows_<byte>(target, (int)c0, columns, rows, lut, z_min, scale);
+				break;
+			case CV_16U:
+				GridRows_<uint16_t>(target, (int)c0, columns, rows, lut, z_min, scale);
+				break;
+			case CV_32F:
+				GridRows_<float>(target, (int)c0, columns, rows, lut, z_min, scale);
+				break;
+			case CV_64F:
+				GridRows_<double>(target, (int)c0, columns, rows, lut, z_min, scale);
+				break;
+			default:
+				break;
+			}
+		}
+
+		//! target rows mapped to the same grid row are copied from the previous one
+		template<typename T>
+		void GridRows_(cv::Mat& target, int c0, const std::vector<int>& columns, const std::vector<int>& rows,
+			const cv::Vec4b* lut, double z_min, double scale)
+		{
+			auto count = columns.size();
+			for (int y = 0; y < target.rows; ++y)
+			{
+				auto r = rows[y];
+				if (r < 0)
+				{
+					continue;
+				}
+				auto dst = target.ptr<cv::Vec4b>(y) + c0;
+				if (y > 0 && rows[y - 1] == r)
+				{
+					auto prev = target.ptr<cv::Vec4b>(y - 1) + c0;
+					std::copy(prev, prev + count, dst);
+					continue;
+				}
+
+				auto src = grid_.ptr<T>(r);
+				for (size_t i = 0; i < count; ++i)
+				{
+					auto v = (src[columns[i]] - z_min) * scale;
+					if constexpr (std::is_floating_point<T>::value)
+					{
+						if (v != v)
+						{
+							continue;
+						}
+					}
+					dst[i] = lut[(int)std::min(255.0, std::max(0.0, v + 0.5))];
+				}
+			}
+		}
+
+		//! bars of the last value of each sample, values at or below y_min are py_0 pixels
+		//! tall, left out when it's 0
+		void DrawBars_(cv::Mat& target, size_t count, double x_0, double spacing, double width,
+			double y_min, double py_delta, double py_0, bool draft)
+		{
 			auto cr = render_color_.ToScalar();
+			int h = target.rows;
+			auto y_of = [&](value_type v) { return (int)((v > y_min) ? (v - y_min) * py_delta : py_0); };
 
-			switch (chart_type_)
+			//! bar i spans [x_0 + i * spacing, + width], only the ones on the target are visited
+			auto begin = (size_t)std::min<double>(count, std::max(0.0, std::floor(-(x_0 + width) / spacing)));
+			auto end = (size_t)std::min<double>(count, std::max(0.0, std::ceil((target.cols - x_0) / spacing) + 1));
+			if (spacing < 1)
 			{
-			case chart::Bar:
+				//! more bars than pixel columns: one band per column, full up to the lowest bar,
+				//! lighter up to the highest, and a line through the means
+				auto band = render_color_.Lift(192).ToScalar();
+				std::vector<cv::Point> means;
+				int column = INT_MIN;
+				int lo = 0;
+				int hi = 0;
+				double sum = 0;
+				size_t n = 0;
+				auto flush = [&]()
+				{
+					if (n > 0)
+					{
+						cv::rectangle(target, { column,h - hi }, { column,h }, band, -1);
+						cv::rectangle(target, { column,h - lo }, { column,h }, cr, -1);
+						means.push_back({ column,h - y_of(sum / n) });
+					}
+				};
+				ForEachOrdinal_(begin, end, [&](size_t i, const value_type* p)
+				{
+					auto c = ToPixel_(x_0 + i * spacing);
+					auto y = y_of(p[dimension_ - 1]);
+					if (c != column)
+					{
+						flush();
+						column = c;
+						lo = hi = y;
+						sum = 0;
+						n = 0;
+					}
+					lo = std::min(lo, y);
+					hi = std::max(hi, y);
+					sum += p[dimension_ - 1];
+					++n;
+				});
+				flush();
+				cv::polylines(target, means, false, render_color_.Cut(90).ToScalar(), 1, cv::LINE_8);
+			}
+			else
 			{
-				auto py_0 = py_delta > 10 ? 0.2 * py_delta : 2;
-				auto x1 = px_start + px_delta * index / (division + 1);
-				auto x2 = x1 + px_delta / (division + 1);
-				int y1 = 0;
-				int y2;
-				int h = target.rows;
 				auto cr1 = render_color_.Cut(90).ToScalar();
 				int fbase;
 				auto fface = cv::FONT_HERSHEY_SIMPLEX;
 				auto fscale = 0.8;
 				cv::Size fsize;
-				for (auto v : values_)
+				int label_end = INT_MIN; //! right edge of the last label (plus a gap), labels reaching left of it are culled
+				int label_half = 0;      //! half its width, the guess for the next label
+				ForEachOrdinal_(begin, end, [&](size_t i, const value_type* p)
+				{
+					auto v = p[dimension_ - 1];
+					auto x1 = x_0 + i * spacing;
+					auto x2 = x1 + width;
+					auto y2 = y_of(v);
+					if (y2 <= 0 && v <= y_min)
+					{
+						return;
+					}
+					cv::rectangle(target, { (int)(x1 + 0.5),h }, { (int)(x2 + 0.5),h - y2 }, cr, -1);
+					//! labels about as wide as the last one are culled unformatted
+					if (!draft && (x1 + x2) / 2 - label_half >= label_end)
+					{
+						char szText[16] = { 0 };
+						snprintf(szText, sizeof(szText), "%g", v);
+						fsize = cv::getTextSize(szText, fface, fscale, 1, &fbase);
+						int left = (int)((x1 + x2 - fsize.width + 0.5)) / 2;
+						if (left >= label_end)
+						{
+							cv::putText(target, szText, { left,h - y2 - fbase }, fface, fscale, cr1, 1, cv::LINE_AA);
+							label_end = left + fsize.width + fsize.height / 2;
+							label_half = fsize.width / 2;
+						}
+					}
+				});
+			}
+		}
+
+		static constexpr int MarkerShape_(marker::Type type)
+		{
+			return type == marker::Cross ? cv::MARKER_TILTED_CROSS
+				: type == marker::Plus ? cv::MARKER_CROSS
+				: type == marker::Star ? cv::MARKER_STAR
+				: type == marker::Square ? cv::MARKER_SQUARE
+				: cv::MARKER_DIAMOND;
+		}
+
+	protected:
+		std::string label_;
+		chart::Type chart_type_;
+		marker::Type marker_type_;
+		cv::Size marker_size_;
+		int dimension_;
+		bool enable_legend_;
+		Color render_color_;
+		std::vector<value_type> values_;
+		std::shared_ptr<util::MappedFile> mapping_;
+		const value_type* mapped_;
+		size_t mapped_count_;
+		size_t stored_count_;
+		dump::Encoding stored_encoding_;
+		uint64_t stored_journal_;
+		bool filter_inf_nan_;
+		mutable int visible_count_;
+		uint64_t epoch_;
+		journal::State journal_;
+		std::shared_ptr<live::Queue> queue_;
+		mutable const value_type* sorted_data_;
+		mutable size_t sorted_count_;
+		mutable bool sorted_x_;
+		bool enable_pyramid_;
+		mutable pyramid::MinMax pyramid_;
+		mutable uint64_t pyramid_epoch_;
+		histogram::Bins bins_;
+		cv::Mat grid_;            //! chart::Heatmap cells, shares the caller's data
+		double grid_extent_[4];   //! x0, x1, y0, y1 of the grid
+		bool dirty_;
+	};
+
+	namespace csv
+	{
+		struct Options
+		{
+			char delimiter = ',';                 //! ',' for CSV, '\t' for TSV
+			bool header = true;                   //! first line holds the column names
+			std::vector<std::string> columns;     //! columns to import by name (needs header)
+			std::vector<int> column_indices;      //! or by 0-based index, default: every column but x
+			std::string x_column;                 //! optional x column by name
+			int x_column_index = -1;              //! or by index, -1 for none
+			chart::Type chart_type = 0;           //! 0 picks Trends without x, Line with x
+			bool filterInfNaN = true;             //! drop samples holding Inf/NaN (or unparsable fields)
+			int threads = 0;                      //! 0 for std::thread::hardware_concurrency()
+		};
+
+		namespace detail
+		{
+			static void Trim(const char*& first, const char*& last)
+			{
+				while (first < last && (*first == ' ' || *first == '\t' || *first == '"'))
+				{
+					++first;
+				}
+				while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '"' || last[-1] == '\r'))
 				{
-					y2 = (int)((v > y_min) ? (v - y_min) * py_delta : py_0);
-					cv::rectangle(target, { (int)(x1 + 0.5),h - y1 }, { (int)(x2 + 0.5),h - y2 }, cr, -1);
-					char szText[16] = { 0 };
-					sprintf_s(szText, "%g", v);
-					fsize = cv::getTextSize(szText, fface, fscale, 1, &fbase);
-					cv::putText(target, szText, { (int)((x1 + x2 - fsize.width + 0.5)) / 2,h - y2 - fbase }, fface, fscale, cr1, 1, cv::LINE_AA);
-					x1 += px_delta;
-					x2 += px_delta;
+					--last;
 				}
 			}
-			break;
-			case chart::Trends:
+
+			//! empty, malformed and out of range fields (1e999, 1e-400) are NaN
+			static double ParseField(const char* first, const char* last)
 			{
-				auto py_0 = py_delta > 10 ? 0.2 * py_delta : 2;
-				auto x_0 = px_start + 0.5 * division * px_delta / (division + 1.1);
-				auto x = x_0;
-				int y;
-				int h = target.rows;
-				std::vector<cv::Point> pts;
-				for (auto v : values_)
+				Trim(first, last);
+				if (first < last && *first == '+')
 				{
-					y = (int)((v > y_min) ? (v - y_min) * py_delta : py_0);
-					pts.push_back({ (int)(x + 0.5),h - y });
-					x += px_delta;
+					++first;
 				}
-				int r = (marker_size_.width + marker_size_.height);
-				r = (r > 2 && r < 32) ? r : 4;
-				cv::polylines(target, pts, false, cr, 1, cv::LINE_AA);
+				double v;
+				auto result = std::from_chars(first, last, v);
+				if (result.ec != std::errc() || result.ptr != last)
+				{
+					return std::numeric_limits<double>::quiet_NaN();
+				}
+				return v;
+			}
 
-				if (marker_type_ != marker::None)
+			static std::vector<std::string> SplitLine(const char* first, const char* last, char delimiter)
+			{
+				std::vector<std::string> fields;
+				auto p = first;
+				for (;;)
 				{
-					DrawMarkers_(target, pts, marker_type_, render_color_.Cut(64), r, 2);
+					auto q = p;
+					while (q < last && *q != delimiter)
+					{
+						++q;
+					}
+					auto f1 = p;
+					auto f2 = q;
+					Trim(f1, f2);
+					fields.push_back(std::string(f1, f2));
+					if (q >= last)
+					{
+						break;
+					}
+					p = q + 1;
+				}
+				return fields;
+			}
 
-					auto cr1 = render_color_.Cut(90).ToScalar();
-					int fbase;
-					auto fface = cv::FONT_HERSHEY_SIMPLEX;
-					auto fscale = 0.8;
-					cv::Size fsize;
-					x = x_0;
-					for (auto v : values_)
+			//! parse the lines of [first, last) into one interleaved value vector per output series
+			static void ParseChunk(const char* first, const char* last, const Options& options,
+				const std::vector<int>& columns, int x_column, int max_column, std::vector<std::vector<double>>& out)
+			{
+				auto n = columns.size();
+				std::vector<double> fields(max_column + 1);
+				out.assign(n, std::vector<double>());
+				auto line = first;
+				while (line < last)
+				{
+					auto eol = (const char*)memchr(line, '\n', last - line);
+					if (eol == nullptr)
 					{
-						y = (int)((v > y_min) ? (v - y_min) * py_delta : py_0);
-						char szText[16] = { 0 };
-						sprintf_s(szText, "%g", v);
-						fsize = cv::getTextSize(szText, fface, fscale, 1, &fbase);
-						cv::putText(target, szText, { (int)(x + 0.5) - fsize.width / 2,h - y - fbase }, fface, fscale, cr1, 1, cv::LINE_AA);
-						x += px_delta;
+						eol = last;
+					}
+
+					//! split only up to the last column of interest
+					std::fill(fields.begin(), fields.end(), std::numeric_limits<double>::quiet_NaN());
+					int index = 0;
+					auto p = line;
+					while (index <= max_column)
+					{
+						auto q = (const char*)memchr(p, options.delimiter, eol - p);
+						auto end = q ? q : eol;
+						fields[index++] = ParseField(p, end);
+						if (q == nullptr)
+						{
+							break;
+						}
+						p = q + 1;
+					}
+
+					bool blank = (eol - line) <= 1 && (line == eol || *line == '\r');
+					if (!blank)
+					{
+						double x = x_column >= 0 ? fields[x_column] : 0.0;
+						bool x_finite = !std::isnan(x) && !std::isinf(x);
+						for (size_t i = 0; i < n; ++i)
+						{
+							double y = fields[columns[i]];
+							bool finite = x_finite && !std::isnan(y) && !std::isinf(y);
+							if (options.filterInfNaN && !finite)
+							{
+								continue;
+							}
+							if (x_column >= 0)
+							{
+								out[i].push_back(x);
+							}
+							out[i].push_back(y);
+						}
 					}
+					line = eol + 1;
 				}
 			}
-			break;
-			case chart::Line:
-			case chart::Scatter:
+		}
+
+		//! import the columns of a delimited text file as series, labelled after their
+		//! header (or "column-<index>"); the file is mapped and parsed in newline-aligned
+		//! chunks on several threads. quoted fields must not contain delimiters or newlines
+		static std::vector<Series> Import(const std::string& filename, const Options& options = Options())
+		{
+			util::MappedFile file(filename);
+			auto data = (const char*)file.GetData();
+			auto begin = data;
+			auto end = data + file.GetSize();
+			if (file.GetSize() >= 3 && memcmp(begin, "\xEF\xBB\xBF", 3) == 0)
+			{
+				begin += 3; //! UTF-8 BOM
+			}
+
+			std::vector<std::string> names;
+			if (options.header && begin < end)
+			{
+				auto eol = (const char*)memchr(begin, '\n', end - begin);
+				eol = eol ? eol : end;
+				names = detail::SplitLine(begin, eol, options.delimiter);
+				begin = eol < end ? eol + 1 : end;
+			}
+
+			auto find_column = [&names](const std::string& name)
 			{
-				int h = target.rows;
-				int ci = 0;
-				std::vector<cv::Point> pts;
-				int x;
-				int y;
-				for (int i = 0; i < values_.size(); i += 2)
+				auto iter = std::find(names.begin(), names.end(), name);
+				if (iter == names.end())
 				{
-					x = (int)(px_start + (values_[i] - x_min) * px_delta + 0.5);
-					y = (int)(py_start + (values_[i + 1] - y_min) * py_delta + 0.5);
-					pts.push_back({ x,h - y });
+					throw std::invalid_argument("column not found: " + name);
 				}
-				int r = (marker_size_.width + marker_size_.height);
-				r = (r > 2 && r < 32) ? r : 4;
+				return (int)(iter - names.begin());
+			};
 
-				if (/*chart_type_ == chart::Trends || */chart_type_ == chart::Line)
-				{
-					DrawMarkers_(target, pts, marker_type_, render_color_.Cut(64), r, 2);
-					cv::polylines(target, pts, false, cr, 1, cv::LINE_AA);
-				}
-				else if (chart_type_ == chart::Scatter)
-				{
-					DrawMarkers_(target, pts, marker_type_, render_color_, r, 2);
-				}
+			int x_column = options.x_column.empty() ? options.x_column_index : find_column(options.x_column);
+			std::vector<int> columns = options.column_indices;
+			for (auto& name : options.columns)
+			{
+				columns.push_back(find_column(name));
 			}
-			break;
-			case chart::Elevation:
+			if (columns.empty())
 			{
-				int h = target.rows;
-				std::vector<cv::Point> pts;
-				std::vector<Color> colors;
-				std::vector<double> zs;
-
-				int x;
-				int y;
-				for (int i = 0; i < values_.size(); i += 3)
+				int count = (int)names.size();
+				if (count == 0 && begin < end)
 				{
-					x = (int)(px_start + (values_[i] - x_min) * px_delta + 0.5);
-					y = (int)(py_start + (values_[i + 1] - y_min) * py_delta + 0.5);
-					pts.push_back({ x,h - y });
+					auto eol = (const char*)memchr(begin, '\n', end - begin);
+					count = (int)detail::SplitLine(begin, eol ? eol : end, options.delimiter).size();
 				}
-				if (z_max > z_min)
+				for (int i = 0; i < count; ++i)
 				{
-					double factor = 1.0 / (z_max - z_min);
-					for (int i = 0; i < values_.size(); i += 3)
+					if (i != x_column)
 					{
-						auto z = (values_[i + 2] - z_min) * factor;
-						colors.push_back(render_color_.Linear(z));
-						zs.push_back(values_[i + 2]);
+						columns.push_back(i);
 					}
 				}
-				else
-				{
-					colors.resize(pts.size(), color::Transparent);
-				}
+			}
 
-				auto block_width = (int)(px_delta);
-				auto block_height = (int)(py_delta);
-				cv::Size fsize;
-				auto fface = cv::FONT_HERSHEY_COMPLEX_SMALL;
-				int fbase;
-				for (int i = 0; i < pts.size(); ++i)
+			int max_column = x_column;
+			for (auto c : columns)
+			{
+				if (c < 0)
 				{
-					cv::Rect rect({ pts[i].x - block_width / 2 + 1,pts[i].y - block_height / 2 + 1,block_width - 2,block_height - 2 });
-					cv::rectangle(target, rect, colors[i].ToScalar(), -1);
-					char sz[32] = { 0 };
-					sprintf_s(sz, "%g", zs[i]);
-					fsize = cv::getTextSize(sz, fface, 1.0, 1, &fbase);
-					cv::putText(target, sz, { pts[i].x - fsize.width / 2,pts[i].y + fsize.height / 2 }, fface, 1.0, colors[i].Reverse().ToScalar(), 1, cv::LINE_AA);
+					throw std::invalid_argument("invalid column index");
 				}
+				max_column = std::max(max_column, c);
 			}
-			break;
-			default:
-				break;
+
+			//! newline-aligned chunks of at least 1 MiB each
+			const size_t MIN_CHUNK = 1 << 20;
+			size_t total = end > begin ? end - begin : 0;
+			int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+			threads = std::max(1, std::min(threads, (int)(total / MIN_CHUNK) + 1));
+			std::vector<const char*> bounds(1, begin);
+			for (int i = 1; i < threads; ++i)
+			{
+				auto p = std::max(bounds.back(), begin + total * i / threads);
+				auto eol = (const char*)memchr(p, '\n', end - p);
+				p = eol ? eol + 1 : end;
+				bounds.push_back(p);
 			}
-		}
+			bounds.push_back(end);
 
-		void Dump(const std::string filename)
-		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, filename.c_str(), "w");
-			if (fp)
+			std::vector<std::vector<std::vector<double>>> parts(threads);
+			util::ParallelFor(threads, [&](size_t i)
 			{
-				fprintf_s(fp, "label=%s\n", label_.c_str());
-				fprintf_s(fp, "%d\n", chart_type_);
-				fprintf_s(fp, "%d\n", marker_type_);
-				fprintf_s(fp, "%d %d\n", marker_size_.width, marker_size_.height);
-				fprintf_s(fp, "%d\n", dimension_);
-				fprintf_s(fp, "%d\n", enable_legend_ ? 1 : 0);
-				auto vec4 = render_color_.ToVec4b(); //BGRA
-				fprintf_s(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
-				int n = values_.size();
-				fprintf_s(fp, "\n%d\n", n);
+				detail::ParseChunk(bounds[i], bounds[i + 1], options, columns, x_column, max_column, parts[i]);
+			}, threads);
+
+			auto type = options.chart_type != 0 ? options.chart_type : (x_column >= 0 ? chart::Line : chart::Trends);
+			if (chart::GetDimension(type) != (x_column >= 0 ? 2 : 1))
+			{
+				throw std::invalid_argument("chart type does not match the x column setting");
 			}
-			fclose(fp);
-		}
 
-		void DumpText(const std::string filename)
-		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, filename.c_str(), "w");
-			if (fp)
+			std::vector<Series> series;
+			series.reserve(columns.size());
+			for (size_t i = 0; i < columns.size(); ++i)
 			{
-				int counter = 0;
-				for (auto v : values_)
+				size_t size = 0;
+				for (auto& part : parts)
 				{
-					fprintf_s(fp, "%g ", v);
-					if (++counter % dimension_ == 0)
-					{
-						fprintf_s(fp, "\n");
-					}
+					size += part[i].size();
+				}
+				std::vector<double> values;
+				values.reserve(size);
+				for (auto& part : parts)
+				{
+					values.insert(values.end(), part[i].begin(), part[i].end());
+					std::vector<double>().swap(part[i]);
 				}
-				fprintf_s(fp, "\n");
+
+				auto c = columns[i];
+				auto label = c < (int)names.size() && !names[c].empty() ? names[c] : "column-" + std::to_string(c);
+				series.emplace_back(label, type);
+				series.back().AddValues(std::move(values));
 			}
-			fclose(fp);
+			return series;
 		}
+	}
 
-		void DumpBinary(const std::string filename)
+	namespace profile
+	{
+		//! wall time (ms) of the View::Render stages, last render. see View::EnableProfiling
+		struct ViewStats
 		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, filename.c_str(), "wb");
-			if (fp && values_.size() > 0)
-			{
-				fwrite(values_.data(), sizeof(value_type), values_.size(), fp);
-			}
-			fclose(fp);
-		}
+			uint64_t renders = 0;
+			double prepare = 0;  //! lazy load + live drain
+			double clear = 0;
+			double ylabel = 0;   //! draw + rotation
+			double bounds = 0;
+			double grid = 0;     //! grid lines and ticks
+			double series = 0;   //! all series, see per_series
+			double legend = 0;
+			double colorbar = 0;
+			double title = 0;
+			double xlabel = 0;
+			double total = 0;
+			std::vector<std::pair<std::string, double>> per_series;
+		};
 
-		Series& Load(const std::string filename)
+		//! wall time (ms) of the Figure::Render_ stages, last frame, summed over the views
+		struct FigureStats
 		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, filename.c_str(), "r");
-			if (fp == nullptr)
+			uint64_t frames = 0;
+			int views = 0;      //! views re-rendered
+			double drain = 0;
+			double render = 0;  //! View::Render
+			double resize = 0;  //! views scaled into the composite
+			double copy = 0;    //! views copied into the composite
+			double total = 0;
+		};
+
+		//! collects complete ("X") events and writes them in the Chrome trace event
+		//! format, open the file in chrome://tracing or Perfetto
+		class Trace
+		{
+		public:
+			Trace() : origin_(std::chrono::steady_clock::now())
 			{
-				throw std::exception("failed to load series");
+				//
 			}
 
-			const int LEN = 256;
-			char sz[LEN] = { 0 };
-			fscanf_s(fp, "%[^\n]", sz, LEN);
-			label_ = std::string(sz).substr(6); //! cut "label="
-			fscanf_s(fp, "%d\n", &chart_type_);
-			fscanf_s(fp, "%d\n", &marker_type_);
-			fscanf_s(fp, "%d %d\n", &(marker_size_.width), &(marker_size_.height));
-			fscanf_s(fp, "%d\n", &dimension_);
-			int enable;
-			fscanf_s(fp, "%d\n", &enable);
-			enable_legend_ = enable > 0;
-			int b, g, r, a;
-			fscanf_s(fp, "%d %d %d %d\n", &b, &g, &r, &a);
-			auto color = Color(r, g, b, a);
-			render_color_ = color;
-			int n;
-			fscanf_s(fp, "%d\n", &n);
-			if (n > 0)
+			void Add(const char* name, std::chrono::steady_clock::time_point start,
+				std::chrono::steady_clock::time_point end, const std::string& detail = "")
 			{
-				values_.resize(n);
+				Event event;
+				event.name = name;
+				event.detail = detail;
+				event.ts = std::chrono::duration<double, std::micro>(start - origin_).count();
+				event.dur = std::chrono::duration<double, std::micro>(end - start).count();
+				event.tid = (uint32_t)(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFF);
+				std::lock_guard<std::mutex> lock(mtx_);
+				events_.push_back(std::move(event));
 			}
-			else
+
+			size_t GetCount()
 			{
-				values_.clear();
+				std::lock_guard<std::mutex> lock(mtx_);
+				return events_.size();
 			}
-			dirty_ = true;
-
-			fclose(fp);
 
-			return *this;
-		}
-
-		Series& LoadText(const std::string filename, const bool filterInfNaN)
-		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, filename.c_str(), "r");
-			if (fp == nullptr)
+			void Clear()
 			{
-				throw std::exception("failed to load series");
+				std::lock_guard<std::mutex> lock(mtx_);
+				events_.clear();
 			}
-			if (values_.size() > 0)
+
+			void Write(const std::string& filename)
 			{
-				for (int i = 0; i < values_.size(); ++i)
-				{
-					fscanf_s(fp, "%lf", &values_[i]);
+				FILE* fp = util::OpenFile(filename, "wb");
+				if (fp == nullptr)
+				{
+					throw std::runtime_error("can't open " + filename);
 				}
-				if (filterInfNaN)
+
+				std::lock_guard<std::mutex> lock(mtx_);
+				fputs("{\"traceEvents\":[\n", fp);
+				for (size_t i = 0; i < events_.size(); ++i)
 				{
-					vector_type vals_;
-					value_type v;
-					for (int i = 0; i < values_.size(); ++i)
+					auto& event = events_[i];
+					fprintf(fp, "{\"name\":\"%s\",\"cat\":\"cvplot\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+						Escape_(event.name).c_str(), event.ts, event.dur, event.tid);
+					if (!event.detail.empty())
 					{
-						fscanf_s(fp, "%lf", &v);
-						if (!isnan(v) && !isinf(v))
-						{
-							vals_.push_back(v);
-						}
+						fprintf(fp, ",\"args\":{\"name\":\"%s\"}", Escape_(event.detail).c_str());
 					}
-					values_ = std::move(vals_);
+					fputs(i + 1 < events_.size() ? "},\n" : "}\n", fp);
 				}
+				fputs("],\"displayTimeUnit\":\"ms\"}\n", fp);
+				fclose(fp);
 			}
-			dirty_ = true;
-
-			fclose(fp);
 
-			return *this;
-		}
-
-		Series& LoadBinary(const std::string filename, const bool filterInfNaN)
-		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, filename.c_str(), "rb");
-			if (fp == nullptr)
+		private:
+			struct Event
 			{
-				throw std::exception("failed to load series");
-			}
+				const char* name;
+				std::string detail;
+				double ts;
+				double dur;
+				uint32_t tid;
+			};
 
-			if (values_.size() > 0)
+			static std::string Escape_(const std::string& str)
 			{
-				fread(values_.data(), sizeof(value_type), values_.size(), fp);
-				if (filterInfNaN)
+				std::string out;
+				for (auto c : str)
 				{
-					vector_type vals_;
-					value_type v;
-					for (int i = 0; i < values_.size(); ++i)
+					if (c == '"' || c == '\\')
 					{
-						v = values_[i];
-						if (!isnan(v) && !isinf(v))
-						{
-							vals_.push_back(v);
-						}
+						out += '\\';
+						out += c;
+					}
+					else if ((unsigned char)c < 0x20)
+					{
+						out += ' ';
+					}
+					else
+					{
+						out += c;
 					}
-					values_ = std::move(vals_);
 				}
-			}
-			dirty_ = true;
-
-			fclose(fp);
-
-			return *this;
-		}
-
-	public:
-		static Series Convert(Series& source, chart::Type chartType)
-		{
-			if (source.GetDimension() != 1 || chart::GetDimension(chartType) != 2)
-			{
-				throw std::exception("conversion not supported");
+				return out;
 			}
 
-			return Series(source, chartType);
-		}
+			std::chrono::steady_clock::time_point origin_;
+			std::vector<Event> events_;
+			std::mutex mtx_;
+		};
 
-	private:
-		void DrawMarkers_(cv::Mat target, std::vector<cv::Point> pts, marker::Type type, Color color, int size, int thickness)
+		//! stage timer: Mark adds the time since the previous mark to a stats field
+		//! (and the trace). does not touch the clock when disabled
+		class Laps
 		{
-			cv::Scalar cr = color.ToScalar();
-			switch (type)
+		public:
+			Laps(bool enabled, Trace* trace) : enabled_(enabled), trace_(trace)
 			{
-			case marker::Cross:
-			{
-				for (auto pt : pts)
+				if (enabled_)
 				{
-					cv::drawMarker(target, pt, cr, cv::MARKER_TILTED_CROSS, size, thickness, cv::LINE_AA);
+					start_ = last_ = std::chrono::steady_clock::now();
 				}
 			}
-			break;
-			case marker::Plus:
+
+			void Mark(double& slot, const char* name)
 			{
-				for (auto pt : pts)
+				if (enabled_)
 				{
-					cv::drawMarker(target, pt, cr, cv::MARKER_CROSS, size, thickness, cv::LINE_AA);
+					Mark_(slot, name, nullptr);
 				}
 			}
-			break;
-			case marker::Star:
+
+			//! detail: e.g. the series label, shown in the trace event args
+			void Mark(double& slot, const char* name, const std::string& detail)
 			{
-				for (auto pt : pts)
+				if (enabled_)
 				{
-					cv::drawMarker(target, pt, cr, cv::MARKER_STAR, size, thickness, cv::LINE_AA);
+					Mark_(slot, name, &detail);
 				}
 			}
-			break;
-			case marker::Circle:
+
+			//! time since construction, also a trace event
+			void Finish(double& slot, const char* name)
 			{
-				for (auto pt : pts)
+				if (enabled_)
 				{
-					cv::circle(target, pt, size / 2, cr, 2, cv::LINE_8);
+					auto now = std::chrono::steady_clock::now();
+					slot = std::chrono::duration<double, std::milli>(now - start_).count();
+					if (trace_)
+					{
+						trace_->Add(name, start_, now);
+					}
 				}
 			}
-			break;
-			case marker::Square:
+
+			bool IsEnabled() const
 			{
-				for (auto pt : pts)
-				{
-					cv::drawMarker(target, pt, cr, cv::MARKER_SQUARE, size, thickness, cv::LINE_AA);
-				}
+				return enabled_;
 			}
-			break;
-			case marker::Diamond:
+
+		private:
+			void Mark_(double& slot, const char* name, const std::string* detail)
 			{
-				for (auto pt : pts)
+				auto now = std::chrono::steady_clock::now();
+				slot += std::chrono::duration<double, std::milli>(now - last_).count();
+				if (trace_)
 				{
-					cv::drawMarker(target, pt, cr, cv::MARKER_DIAMOND, size, thickness, cv::LINE_AA);
+					trace_->Add(name, last_, now, detail ? *detail : std::string());
 				}
+				last_ = now;
 			}
-			break;
-			default:
-				break;
-			}
-		}
 
-	protected:
-		std::string label_;
-		chart::Type chart_type_;
-		marker::Type marker_type_;
-		cv::Size marker_size_;
-		int dimension_;
-		bool enable_legend_;
-		Color render_color_;
-		std::vector<value_type> values_;
-		bool dirty_;
-	};
+			bool enabled_;
+			Trace* trace_;
+			std::chrono::steady_clock::time_point start_;
+			std::chrono::steady_clock::time_point last_;
+		};
+	}
+
+	class Figure;
 
 	class View
 	{
+		friend class Figure;
+
 	public:
 		View(std::string title, cv::Size size)
 			:title_(title),
@@ -1009,10 +5980,20 @@ namespace cvplot
 			dirty_(false),
 			horizontal_margin_(50),
 			vertical_margin_(80),
+			pending_filter_(true),
+			pending_mapped_(false),
 			x_min_(0), y_min_(0),
 			px_start_(0), py_start_(0),
 			px_delta_(0), py_delta_(0),
-			dimension_(0)
+			dimension_(0),
+			x_max_(1), y_max_(1),
+			has_viewport_(false),
+			auto_y_(false),
+			viewport_{ 0,1,0,1 },
+			profiling_(false),
+			render_size_({ 0,0 }),
+			extent_(size),
+			quality_(quality::Full)
 		{
 			if (size.width > 0 && size.height > 0)
 			{
@@ -1026,30 +6007,28 @@ namespace cvplot
 			//
 		}
 
-		View& operator=(View& rhs)
+		View(const View& rhs) = default;
+		View(View&& rhs) = default;
+
+		View& operator=(const View& rhs)
+		{
+			if (this != &rhs && rhs.IsValid())
+			{
+				Assign_(rhs);
+				series_map_ = rhs.series_map_;
+				pending_ = rhs.pending_;
+			}
+			return *this;
+		}
+
+		//! takes the series instead of copying them
+		View& operator=(View&& rhs)
 		{
 			if (this != &rhs && rhs.IsValid())
 			{
-				title_ = rhs.title_;
-				size_ = rhs.size_;
-				xlabel_ = rhs.xlabel_;
-				ylabel_ = rhs.ylabel_;
-				background_color_ = rhs.background_color_;
-				text_color_ = rhs.text_color_;
-				enable_grid_ = rhs.enable_grid_;
-				grid_color_ = rhs.grid_color_;
-				horizontal_margin_ = rhs.horizontal_margin_;
-				vertical_margin_ = rhs.vertical_margin_;
-				buffer_ = rhs.buffer_.clone();
+				Assign_(rhs);
 				series_map_ = std::move(rhs.series_map_);
-				dirty_ = true;
-				x_min_ = 0;
-				y_min_ = 0;
-				px_start_ = 0;
-				px_delta_ = 1;
-				py_start_ = 0;
-				py_delta_ = 1;
-				dimension_ = rhs.dimension_;
+				pending_ = std::move(rhs.pending_);
 			}
 			return *this;
 		}
@@ -1066,22 +6045,18 @@ namespace cvplot
 
 		View& SetSize(cv::Size size)
 		{
+			size = ClampSize_(size);
 			if (size_ != size)
 			{
-				if (size.width < 400 || size.height < 400)
-				{
-					size.width = std::max({ size.width, 400 });
-					size.height = std::max({ size.height, 400 });
-				}
-
 				if (buffer_.empty())
 				{
 					buffer_ = cv::Mat(size, CV_8UC4, color::Transparent.ToScalar());
 				}
 				else
 				{
-					auto tmp = buffer_.clone();
-					cv::resize(tmp, buffer_, size);
+					cv::Mat tmp;
+					cv::resize(buffer_, tmp, size);
+					buffer_ = tmp;
 				}
 				size_ = size;
 				dirty_ = true;
@@ -1089,6 +6064,27 @@ namespace cvplot
 			return *this;
 		}
 
+		//! draw at size pixels instead of GetSize, margins, text and the color bar scale along.
+		//! Zoom, Pan and Capture keep taking GetSize coordinates. {0,0} renders at GetSize
+		View& SetRenderSize(cv::Size size)
+		{
+			if (size.width <= 0 || size.height <= 0)
+			{
+				size = { 0,0 };
+			}
+			if (render_size_ != size)
+			{
+				render_size_ = size;
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		cv::Size GetRenderSize() const
+		{
+			return render_size_.width > 0 ? render_size_ : size_;
+		}
+
 		View& SetTextColor(Color color)
 		{
 			if (text_color_ != color)
@@ -1155,111 +6151,251 @@ namespace cvplot
 			return (iter != series_map_.end());
 		}
 
+		//! the view keeps a copy, a live queue moves to it (the caller's series no longer drains it)
 		View& AddSeries(Series& series)
+		{
+			return AddSeries_(series);
+		}
+
+		View& AddSeries(Series&& series)
+		{
+			return AddSeries_(std::move(series));
+		}
+
+	private:
+		template<typename S>
+		View& AddSeries_(S&& series)
 		{
 			if (dimension_ == 3)
 			{
-				throw std::exception("series of this type is exclusive");
+				throw std::runtime_error("series of this type is exclusive");
 			}
 
 			int dim = series.GetDimension();
 			if (dimension_ > 0 && dimension_ != dim)
 			{
-				throw std::exception("series dimension confilict");
+				throw std::runtime_error("series dimension confilict");
 			}
 
 			auto label = series.GetLabel();
 			if (series_map_.find(label) == series_map_.end())
 			{
 				dimension_ = dim;
-				series_map_.insert({ label, series });
+				auto queue = series.GetLiveQueue();
+				auto& added = series_map_.emplace(label, std::forward<S>(series)).first->second;
+				if (queue)
+				{
+					//! the view becomes the only consumer of the queue, even for a copy
+					added.SetLive(queue);
+					series.SetLive(std::shared_ptr<live::Queue>());
+				}
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+	public:
+		View& Remove(const std::string label)
+		{
+			auto iter = series_map_.find(label);
+			if (iter != series_map_.end())
+			{
+				series_map_.erase(label);
+				pending_.erase(label);
 				dirty_ = true;
 			}
+			if (series_map_.empty())
+			{
+				dimension_ = 0;
+			}
+			return *this;
+		}
+
+		View& Clear()
+		{
+			if (!series_map_.empty())
+			{
+				series_map_.clear();
+				dirty_ = true;
+			}
+			pending_.clear();
+			dimension_ = 0;
 			return *this;
 		}
 
-		View& Remove(const std::string label)
+		//! loads the series data first if the view was loaded lazily
+		Series& SelectSeries(std::string label)
+		{
+			auto iter = series_map_.find(label);
+			if (iter == series_map_.end())
+			{
+				throw std::runtime_error("series not found");
+			}
+			else
+			{
+				auto pending = pending_.find(label);
+				if (pending != pending_.end())
+				{
+					LoadSeries_(iter->second, pending->second, pending_filter_, pending_mapped_);
+					pending_.erase(pending);
+					dirty_ = true;
+				}
+				return iter->second;
+			}
+		}
+
+		//! true while some series only hold the metadata of a lazy load
+		bool IsPending() const
+		{
+			return !pending_.empty();
+		}
+
+		//! load everything a lazy load deferred: series data and the view buffer
+		View& Materialize()
 		{
-			auto iter = series_map_.find(label);
-			if (iter != series_map_.end())
+			if (!pending_.empty())
 			{
-				series_map_.erase(label);
+				std::vector<std::pair<Series*, std::string>> tasks;
+				for (auto& p : pending_)
+				{
+					tasks.push_back({ &series_map_[p.first], p.second });
+				}
+				util::ParallelFor(tasks.size(), [&](size_t i)
+				{
+					LoadSeries_(*tasks[i].first, tasks[i].second, pending_filter_, pending_mapped_);
+				});
+				pending_.clear();
 				dirty_ = true;
 			}
-			if (series_map_.empty())
+			if (buffer_.empty() && size_.width > 0 && size_.height > 0)
 			{
-				dimension_ = 0;
+				buffer_ = cv::Mat(size_, CV_8UC4, color::Transparent.ToScalar());
+				dirty_ = true;
 			}
 			return *this;
 		}
 
-		View& Clear()
+		//! let a source (e.g. metric::Flusher) add live series on every Drain, the view
+		//! only keeps a weak reference
+		View& AddSource(std::shared_ptr<live::Source> source)
 		{
-			if (!series_map_.empty())
-			{
-				series_map_.clear();
-				dirty_ = true;
-			}
-			dimension_ = 0;
+			sources_.push_back(source);
 			return *this;
 		}
 
-		Series& SelectSeries(std::string label)
+		//! pull the samples producers pushed into live series, true if any arrived
+		bool Drain()
 		{
-			auto iter = series_map_.find(label);
-			if (iter == series_map_.end())
+			for (size_t i = 0; i < sources_.size();)
 			{
-				throw std::exception("series not found");
+				auto source = sources_[i].lock();
+				if (source)
+				{
+					source->Feed(*this);
+					++i;
+				}
+				else
+				{
+					sources_.erase(sources_.begin() + i);
+				}
 			}
-			else
+
+			bool arrived = false;
+			for (auto& s : series_map_)
 			{
-				return iter->second;
+				if (s.second.Drain() > 0)
+				{
+					arrived = true;
+				}
+			}
+			if (arrived)
+			{
+				dirty_ = true;
 			}
+			return arrived;
 		}
 
-		View& Render()
+		//! quality::Draft draws a quick preview (see Series::Draw) without text, a later
+		//! Render(quality::Full) refines it even if nothing changed. see GetQuality
+		View& Render(quality::Type quality = quality::Full)
 		{
-			if (series_map_.empty() || dimension_ == 0)
+			if (quality > quality_)
+			{
+				dirty_ = true;
+			}
+			profile::Laps laps(profiling_ && dirty_, trace_.get());
+			profile::ViewStats stats;
+			Materialize();
+			Drain();
+			auto extent = GetRenderSize();
+			if (series_map_.empty() || dimension_ == 0 || extent.width <= 0 || extent.height <= 0)
 			{
 				dirty_ = false;
+				quality_ = quality::Full; //! nothing to refine
 			}
+			laps.Mark(stats.prepare, "prepare");
 
 			if (dirty_)
 			{
+				bool draft = quality == quality::Draft;
+				//! laid out over extent: GetSize, or the render size with margins, text and
+				//! decorations scaled by it (ts)
+				auto frame = render_size_.width > 0 ? extent : cv::Size(std::max(buffer_.cols, extent.width), std::max(buffer_.rows, extent.height));
+				auto margins = Margins_(extent);
+				int hm = margins.x;
+				int vm = margins.y;
+				auto scale = Scale_(extent);
+				double ts = std::min(scale.x, scale.y);
+				int thick = std::max(1, (int)(2 * ts + 0.5));
+				extent_ = extent;
+
+				//! frames handed out by GetFrame (or shared by copies of this view) keep
+				//! the last render, draw into new pixels instead
+				if (util::IsShared(buffer_) || buffer_.size() != frame)
+				{
+					buffer_ = cv::Mat(frame, CV_8UC4);
+				}
+
 				//erase view with background
-				//buffer_.setTo(background_color_.ToScalar());
+				buffer_.setTo(background_color_.ToScalar());
+				laps.Mark(stats.clear, "clear");
 
-				int res_width = size_.width - 2 * horizontal_margin_;
-				int res_height = size_.height - 2 * vertical_margin_;
+				int res_width = extent.width - 2 * hm;
+				int res_height = extent.height - 2 * vm;
 
-				double pad = 60.0 / (std::max(res_width, res_height));
+				double pad = 60.0 / (std::max(res_width / scale.x, res_height / scale.y));
 				double par = 1.0 - 2 * pad;
 
 				//draw y label
-				if (!ylabel_.empty())
+				if (!ylabel_.empty() && !draft)
 				{
 					auto fface = cv::FONT_HERSHEY_TRIPLEX;
 					int fbase;
-					auto fscale = 1.0;
-					auto fsize = cv::getTextSize(ylabel_, fface, fscale, 2, &fbase);
+					auto fscale = 1.0 * ts;
+					auto fsize = cv::getTextSize(ylabel_, fface, fscale, thick, &fbase);
 					int sq_size = res_width < res_height ? res_width : res_height;
-					cv::Rect rect(0, res_height / 2 + vertical_margin_ - sq_size / 2, sq_size, sq_size);
+					cv::Rect rect(0, res_height / 2 + vm - sq_size / 2, sq_size, sq_size);
 					auto mat = buffer_(rect);
 					int offset = sq_size > 800 ? (int)(pad * sq_size / 8) : (int)(pad * sq_size / 16);
-					cv::Point pt(sq_size / 2 - fsize.width / 2, horizontal_margin_ + offset - fsize.height);
-					cv::putText(mat, ylabel_, pt, fface, fscale, text_color_.ToScalar(), 2, cv::LINE_AA);
+					cv::Point pt(sq_size / 2 - fsize.width / 2, hm + offset - fsize.height);
+					cv::putText(mat, ylabel_, pt, fface, fscale, text_color_.ToScalar(), thick, cv::LINE_AA);
 					auto rm = cv::getRotationMatrix2D({ sq_size / 2.0f,sq_size / 2.0f }, 90, 1.0);
 					cv::warpAffine(mat, mat, rm, { sq_size, sq_size }, cv::WARP_FILL_OUTLIERS, cv::BORDER_TRANSPARENT, color::Transparent.ToScalar());
 				}
+				laps.Mark(stats.ylabel, "ylabel");
 
-				cv::Rect roi(horizontal_margin_, vertical_margin_, res_width, res_height);
+				cv::Rect roi(hm, vm, res_width, res_height);
 				auto target = buffer_(roi);
 
 				std::vector<double> mins(dimension_, DBL_MAX);
 				std::vector<double> maxs(dimension_, DBL_MIN);
 
+				//! a viewport replaces the data bounds, only z (the color scale) still needs a scan
+				bool scan = !has_viewport_ || dimension_ == 3;
+				double fit_min = DBL_MAX;
+				double fit_max = -DBL_MAX;
 				int sample_count = 0;
-				for (auto s : series_map_)
+				for (auto& s : series_map_)
 				{
 					auto count1 = s.second.GetSampleCount();
 					auto dim1 = s.second.GetDimension();
@@ -1269,8 +6405,24 @@ namespace cvplot
 						{
 							sample_count = count1;
 						}
-						auto mins1 = s.second.CalcMin();
-						auto maxs1 = s.second.CalcMax();
+						if (has_viewport_ && auto_y_)
+						{
+							std::vector<double> mins1;
+							std::vector<double> maxs1;
+							auto y = dimension_ == 1 ? 0 : 1;
+							if (s.second.CalcRange(viewport_[0], viewport_[1], mins1, maxs1))
+							{
+								fit_min = std::min(fit_min, mins1[y]);
+								fit_max = std::max(fit_max, maxs1[y]);
+							}
+						}
+						if (!scan)
+						{
+							continue;
+						}
+						std::vector<double> mins1;
+						std::vector<double> maxs1;
+						s.second.CalcBounds(mins1, maxs1);
 						for (int i = 0; i < dimension_; ++i)
 						{
 							if (mins1[i] < mins[i])
@@ -1324,12 +6476,29 @@ namespace cvplot
 					break;
 				}
 
+				if (has_viewport_)
+				{
+					x_min_ = viewport_[0];
+					x_max = viewport_[1];
+					y_min_ = auto_y_ ? fit_min : viewport_[2];
+					y_max = auto_y_ ? fit_max : viewport_[3];
+					if (!(y_min_ < y_max))
+					{
+						//! nothing (or a constant) in range
+						y_min_ = y_min_ <= y_max ? y_min_ - 0.5 : 0;
+						y_max = y_min_ + 1;
+					}
+				}
+				x_max_ = x_max;
+				y_max_ = y_max;
+
 				double px_size = par * res_width;
 				double py_size = par * res_height;
 				px_start_ = pad * res_width;
 				py_start_ = pad * res_height;
 				px_delta_ = px_size / (x_max - x_min_);
 				py_delta_ = py_size / (y_max - y_min_);
+				laps.Mark(stats.bounds, "bounds");
 
 				//draw axis grids
 				if (enable_grid_)
@@ -1347,7 +6516,7 @@ namespace cvplot
 						auto y_offset = (dimension_ == 1 ? py_start_ : 0.0);
 
 						// horizontal grid lines
-						x = horizontal_margin_;
+						x = hm;
 						for (auto v = std::ceil(y_min_ / y_snap) * y_snap; v <= y_max; v += y_snap)
 						{
 							if (v > -DBL_EPSILON && v < DBL_EPSILON)
@@ -1361,11 +6530,14 @@ namespace cvplot
 							std::ostringstream out;
 							out << std::setprecision(4) << v;
 							auto str = out.str();
-							cv::Size fsize = getTextSize(str, fface, 0.5, 1, &fbase);
+							cv::Size fsize = getTextSize(str, fface, 0.5 * ts, 1, &fbase);
 							y = res_height + y_offset - (int)(py_start_ + (v - y_min_) * py_delta_ + 0.5);
 							cv::line(target, { fsize.width, y }, { res_width - 1, y }, gridLineColor, 1, cv::LINE_4);
-							cv::Point org(x, y + vertical_margin_ + fsize.height / 2);
-							cv::putText(buffer_, str, org, fface, 0.5, text_color_.ToScalar(), 1);
+							cv::Point org(x, y + vm + fsize.height / 2);
+							if (!draft)
+							{
+								cv::putText(buffer_, str, org, fface, 0.5 * ts, text_color_.ToScalar(), 1);
+							}
 						}
 
 						if (dimension_ >= 2)
@@ -1374,7 +6546,7 @@ namespace cvplot
 							const double SNAP = (int)(px_start_ / px_delta_);
 							auto x_snap = std::max(CalcSnap_(x_max - x_min_) / 10, SNAP);
 
-							y = res_height + vertical_margin_;
+							y = res_height + vm;
 							for (auto v = std::floor(x_min_ / x_snap) * x_snap; v < x_max + x_snap; v += x_snap)
 							{
 								if (v > -DBL_EPSILON && v < DBL_EPSILON)
@@ -1384,19 +6556,24 @@ namespace cvplot
 								std::ostringstream out;
 								out << std::setprecision(4) << v;
 								auto str = out.str();
-								cv::Size fsize = getTextSize(str, fface, 0.5, 1, &fbase);
+								cv::Size fsize = getTextSize(str, fface, 0.5 * ts, 1, &fbase);
 								x = (int)(px_start_ + (v - x_min_) * px_delta_ + 0.5);
 								cv::line(target, { x, 1 }, { x, res_height - fsize.height }, gridLineColor, 1, cv::LINE_4);
-								cv::Point org(x + horizontal_margin_ - fsize.width / 2, y);
-								cv::putText(buffer_, str, org, fface, 0.5, text_color_.ToScalar(), 1);
+								cv::Point org(x + hm - fsize.width / 2, y);
+								if (!draft)
+								{
+									cv::putText(buffer_, str, org, fface, 0.5 * ts, text_color_.ToScalar(), 1);
+								}
 							}
 						}
 					}
 				}
 
+				laps.Mark(stats.grid, "grid");
+
 				//draw series
 				int division = 0;
-				for (auto s : series_map_)
+				for (auto& s : series_map_)
 				{
 					if (s.second.GetChartType() == chart::Bar)
 					{
@@ -1404,28 +6581,34 @@ namespace cvplot
 					}
 				}
 				int index = 0;
-				for (auto s : series_map_)
+				for (auto& s : series_map_)
 				{
-					s.second.Draw(target, index, division, x_min_, x_max, y_min_, y_max, z_min, z_max, px_start_, py_start_, px_delta_, py_delta_);
+					s.second.Draw(target, index, division, x_min_, x_max, y_min_, y_max, z_min, z_max, px_start_, py_start_, px_delta_, py_delta_, quality);
 					++index;
+					if (laps.IsEnabled())
+					{
+						stats.per_series.push_back({ s.first, 0.0 });
+						laps.Mark(stats.per_series.back().second, "series", s.first);
+						stats.series += stats.per_series.back().second;
+					}
 				}
 
 				//draw legend
-				int legend_size = 6;
-				int legend_x = res_width + horizontal_margin_;
-				int legend_y = vertical_margin_ + 20;
+				int legend_size = std::max(2, (int)(6 * ts + 0.5));
+				int legend_x = res_width + hm;
+				int legend_y = vm + (int)(20 * ts + 0.5);
 				int ci = 256 / (series_map_.size() + 1);
-				for (auto s : series_map_)
+				for (auto& s : series_map_)
 				{
-					if (s.second.IsLegendEnabled())
+					if (s.second.IsLegendEnabled() && !draft)
 					{
 						auto fface = cv::FONT_HERSHEY_COMPLEX_SMALL;
 						int fbase;
-						auto fsize = cv::getTextSize(s.first, fface, 1.0, 1, &fbase);
+						auto fsize = cv::getTextSize(s.first, fface, 1.0 * ts, 1, &fbase);
 						legend_size = legend_size < fsize.height ? legend_size : fsize.height;
 						cv::Point pt(legend_x - 4 * legend_size - fsize.width, legend_y);
 						auto cr = s.second.GetRenderColor().ToScalar();
-						cv::putText(buffer_, s.first, pt, fface, 1.0, text_color_.ToScalar(), 1, cv::LINE_AA);
+						cv::putText(buffer_, s.first, pt, fface, 1.0 * ts, text_color_.ToScalar(), 1, cv::LINE_AA);
 						auto chartType = s.second.GetChartType();
 
 						if (s.second.GetChartType() == chart::Line)
@@ -1433,29 +6616,29 @@ namespace cvplot
 							cv::line(buffer_,
 								{ legend_x - 2 * legend_size - 4,legend_y - (fsize.height - fbase) / 2 },
 								{ legend_x - legend_size,legend_y - (fsize.height - fbase) / 2 },
-								cr, 2, cv::LINE_AA);
+								cr, thick, cv::LINE_AA);
 						}
 						else
 						{
 							switch (s.second.GetMarkerType())
 							{
 							case marker::Cross:
-								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_TILTED_CROSS, legend_size * 2, 2, cv::LINE_AA);
+								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_TILTED_CROSS, legend_size * 2, thick, cv::LINE_AA);
 								break;
 							case marker::Plus:
-								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_CROSS, legend_size * 2, 2, cv::LINE_AA);
+								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_CROSS, legend_size * 2, thick, cv::LINE_AA);
 								break;
 							case marker::Star:
-								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_STAR, legend_size * 2, 2, cv::LINE_AA);
+								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_STAR, legend_size * 2, thick, cv::LINE_AA);
 								break;
 							case marker::Square:
-								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_SQUARE, legend_size * 2, 2, cv::LINE_AA);
+								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_SQUARE, legend_size * 2, thick, cv::LINE_AA);
 								break;
 							case marker::Diamond:
-								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_DIAMOND, legend_size * 2, 2, cv::LINE_AA);
+								cv::drawMarker(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, cr, cv::MARKER_DIAMOND, legend_size * 2, thick, cv::LINE_AA);
 								break;
 							case marker::Circle:
-								cv::circle(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, legend_size, cr, 2, cv::LINE_AA);
+								cv::circle(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, legend_size, cr, thick, cv::LINE_AA);
 								break;
 							default:
 								cv::circle(buffer_, { legend_x - 2 * legend_size,legend_y - (fsize.height - fbase) / 2 }, legend_size, cr, -1, cv::LINE_AA);
@@ -1466,15 +6649,16 @@ namespace cvplot
 						legend_y += 2 * fsize.height;
 					}
 				}
+				laps.Mark(stats.legend, "legend");
 
 				//draw color bar
 				if (dimension_ == 3)
 				{
 					auto render_color = series_map_.begin()->second.GetRenderColor();
-					int bar_width = 20;
-					int bar_margin = 20;
+					int bar_width = std::max(1, (int)(20 * ts + 0.5));
+					int bar_margin = (int)(20 * ts + 0.5);
 					const int N_COLORS = 256;
-					cv::Rect rect(res_width + horizontal_margin_ + par * bar_margin, vertical_margin_ + bar_margin, bar_width, res_height - 2 * bar_margin);
+					cv::Rect rect(res_width + hm + par * bar_margin, vm + bar_margin, bar_width, res_height - 2 * bar_margin);
 					cv::Mat mat(N_COLORS, bar_width, CV_8UC4);
 					for (int i = 0; i < N_COLORS; ++i)
 					{
@@ -1488,54 +6672,201 @@ namespace cvplot
 					cv::resize(mat, tmp, { tmp.cols,tmp.rows });
 					tmp.copyTo(buffer_(rect));
 
-					auto fface = cv::FONT_HERSHEY_SIMPLEX;
-					int fbase;
-					auto fsacle = 0.5;
-
-					char sz1[16] = { 0 };
-					sprintf_s(sz1, "%g", z_min);
-					auto fsize1 = cv::getTextSize(sz1, fface, fsacle, 1, &fbase);
-					cv::Point pt1(rect.x + bar_width / 2 - 3 * fsize1.width / 4, rect.y + rect.height + bar_margin + 5);
-					cv::putText(buffer_, sz1, pt1, fface, fsacle, color::Black.ToScalar(), 1, cv::LINE_AA);
-
-					char sz2[16] = { 0 };
-					sprintf_s(sz2, "%g", z_max);
-					auto fsize2 = cv::getTextSize(sz2, fface, fsacle, 1, &fbase);
-					cv::Point pt2(rect.x + bar_width / 2 - 3 * fsize2.width / 4, rect.y - fsize2.height - fbase);
-					cv::putText(buffer_, sz2, pt2, fface, fsacle, render_color.ToScalar(), 1, cv::LINE_AA);
+					if (!draft)
+					{
+						auto fface = cv::FONT_HERSHEY_SIMPLEX;
+						int fbase;
+						auto fsacle = 0.5 * ts;
+
+						char sz1[16] = { 0 };
+						snprintf(sz1, sizeof(sz1), "%g", z_min);
+						auto fsize1 = cv::getTextSize(sz1, fface, fsacle, 1, &fbase);
+						cv::Point pt1(rect.x + bar_width / 2 - 3 * fsize1.width / 4, rect.y + rect.height + bar_margin + (int)(5 * ts + 0.5));
+						cv::putText(buffer_, sz1, pt1, fface, fsacle, color::Black.ToScalar(), 1, cv::LINE_AA);
+
+						char sz2[16] = { 0 };
+						snprintf(sz2, sizeof(sz2), "%g", z_max);
+						auto fsize2 = cv::getTextSize(sz2, fface, fsacle, 1, &fbase);
+						cv::Point pt2(rect.x + bar_width / 2 - 3 * fsize2.width / 4, rect.y - fsize2.height - fbase);
+						cv::putText(buffer_, sz2, pt2, fface, fsacle, render_color.ToScalar(), 1, cv::LINE_AA);
+					}
 				}
+				laps.Mark(stats.colorbar, "colorbar");
 
 				//draw title
-				if (!title_.empty())
+				if (!title_.empty() && !draft)
 				{
 					auto fface = cv::FONT_HERSHEY_SIMPLEX;
 					int fbase;
-					auto fsize = cv::getTextSize(title_, fface, 1.5, 2, &fbase);
-					cv::Point pt(res_width / 2 + horizontal_margin_ - fsize.width / 2, vertical_margin_ > fsize.height ? vertical_margin_ - fsize.height : 5);
-					cv::putText(buffer_, title_, pt, fface, 1.5, color::Black.ToScalar(), 2, cv::LINE_AA);
+					auto fsize = cv::getTextSize(title_, fface, 1.5 * ts, thick, &fbase);
+					cv::Point pt(res_width / 2 + hm - fsize.width / 2, vm > fsize.height ? vm - fsize.height : 5);
+					cv::putText(buffer_, title_, pt, fface, 1.5 * ts, color::Black.ToScalar(), thick, cv::LINE_AA);
 				}
+				laps.Mark(stats.title, "title");
 
 				//draw x label
-				if (!xlabel_.empty())
+				if (!xlabel_.empty() && !draft)
 				{
 					auto fface = cv::FONT_HERSHEY_TRIPLEX;
 					int fbase;
-					auto fsize = cv::getTextSize(xlabel_, fface, 1.0, 2, &fbase);
-					cv::Point pt(res_width / 2 + horizontal_margin_ - fsize.width / 2, res_height + vertical_margin_ + fsize.height + 5);
-					cv::putText(buffer_, xlabel_, pt, fface, 1.0, text_color_.ToScalar(), 2, cv::LINE_AA);
+					auto fsize = cv::getTextSize(xlabel_, fface, 1.0 * ts, thick, &fbase);
+					cv::Point pt(res_width / 2 + hm - fsize.width / 2, res_height + vm + fsize.height + (int)(5 * ts + 0.5));
+					cv::putText(buffer_, xlabel_, pt, fface, 1.0 * ts, text_color_.ToScalar(), thick, cv::LINE_AA);
 				}
+				laps.Mark(stats.xlabel, "xlabel");
 
 				dirty_ = false;
+				quality_ = quality;
+			}
+
+			if (laps.IsEnabled())
+			{
+				laps.Finish(stats.total, "View::Render");
+				stats.renders = render_stats_.renders + 1;
+				render_stats_ = std::move(stats);
 			}
+			return *this;
+		}
 
+		//! time the Render stages (GetRenderStats), events also go to trace when given.
+		//! off by default, the disabled timers never read the clock
+		View& EnableProfiling(bool enable, std::shared_ptr<profile::Trace> trace = nullptr)
+		{
+			profiling_ = enable;
+			trace_ = enable ? trace : nullptr;
 			return *this;
 		}
 
+		bool IsProfiling() const
+		{
+			return profiling_;
+		}
+
+		//! stage timings of the last profiled render
+		const profile::ViewStats& GetRenderStats() const
+		{
+			return render_stats_;
+		}
+
 		void Invalidate()
 		{
 			dirty_ = true;
 		}
 
+		//! show only [x0, x1] x [y0, y1] instead of the data bounds, Line/Scatter/Trends/Elevation
+		//! then only visit the samples that can be visible (x0/x1 are sample numbers for dimension 1)
+		View& SetViewport(double x0, double x1, double y0, double y1)
+		{
+			if (!(x0 < x1) || !(y0 < y1) || !std::isfinite(x1 - x0) || !std::isfinite(y1 - y0))
+			{
+				throw std::invalid_argument("invalid viewport");
+			}
+			has_viewport_ = true;
+			auto_y_ = false;
+			viewport_[0] = x0;
+			viewport_[1] = x1;
+			viewport_[2] = y0;
+			viewport_[3] = y1;
+			dirty_ = true;
+			return *this;
+		}
+
+		//! show only [x0, x1], y fits the samples in that range (see Series::CalcRange).
+		//! Zoom and Pan keep y fitted
+		View& SetViewport(double x0, double x1)
+		{
+			if (!(x0 < x1) || !std::isfinite(x1 - x0))
+			{
+				throw std::invalid_argument("invalid viewport");
+			}
+			has_viewport_ = true;
+			auto_y_ = true;
+			viewport_[0] = x0;
+			viewport_[1] = x1;
+			dirty_ = true;
+			return *this;
+		}
+
+		//! back to the data bounds
+		View& ResetViewport()
+		{
+			if (has_viewport_)
+			{
+				has_viewport_ = false;
+				dirty_ = true;
+			}
+			return *this;
+		}
+
+		bool HasViewport() const
+		{
+			return has_viewport_;
+		}
+
+		//! {x0, x1, y0, y1} of the last render (or the pending viewport)
+		cv::Vec4d GetViewport() const
+		{
+			if (has_viewport_ && !auto_y_)
+			{
+				return { viewport_[0], viewport_[1], viewport_[2], viewport_[3] };
+			}
+			if (has_viewport_)
+			{
+				return { viewport_[0], viewport_[1], y_min_, y_max_ };
+			}
+			return { x_min_, x_max_, y_min_, y_max_ };
+		}
+
+		//! zoom around the view pixel (x, y), factor > 1 zooms in. needs a previous render
+		View& Zoom(double x, double y, double factor)
+		{
+			if (px_delta_ <= 0 || py_delta_ <= 0 || !(factor > 0))
+			{
+				return *this;
+			}
+
+			auto viewport = GetViewport();
+			auto margins = Margins_(extent_);
+			ToExtent_(x, y);
+			auto x_val = (x - px_start_ - margins.x) / px_delta_ + x_min_;
+			auto y_offset = dimension_ == 1 ? 0.0 : py_start_;
+			auto y_val = (extent_.height - y - y_offset - margins.y) / py_delta_ + y_min_;
+			x_val = std::max(viewport[0], std::min(viewport[1], x_val));
+			y_val = std::max(viewport[2], std::min(viewport[3], y_val));
+			auto x0 = x_val - (x_val - viewport[0]) / factor;
+			auto x1 = x_val + (viewport[1] - x_val) / factor;
+			auto y0 = y_val - (y_val - viewport[2]) / factor;
+			auto y1 = y_val + (viewport[3] - y_val) / factor;
+			if (has_viewport_ && auto_y_ && x0 < x1)
+			{
+				SetViewport(x0, x1);
+			}
+			else if (x0 < x1 && y0 < y1)
+			{
+				SetViewport(x0, x1, y0, y1);
+			}
+			return *this;
+		}
+
+		//! move the content by (dx, dy) view pixels, like dragging it
+		View& Pan(double dx, double dy)
+		{
+			if (px_delta_ <= 0 || py_delta_ <= 0)
+			{
+				return *this;
+			}
+
+			auto viewport = GetViewport();
+			ToExtent_(dx, dy);
+			auto x_shift = -dx / px_delta_;
+			auto y_shift = dy / py_delta_;
+			if (has_viewport_ && auto_y_)
+			{
+				return SetViewport(viewport[0] + x_shift, viewport[1] + x_shift);
+			}
+			return SetViewport(viewport[0] + x_shift, viewport[1] + x_shift, viewport[2] + y_shift, viewport[3] + y_shift);
+		}
+
 		std::string Capture(double x, double y)
 		{
 			if (dirty_ || series_map_.empty() /*|| dimension_ != 2*/
@@ -1545,28 +6876,30 @@ namespace cvplot
 				return "";
 			}
 
+			auto margins = Margins_(extent_);
+			ToExtent_(x, y);
 			switch (dimension_)
 			{
 			case 1:
 			{
-				auto x_val = floor((x - px_start_ - horizontal_margin_) / px_delta_ + x_min_ + 0.05);
-				auto y_val = (size_.height - y - vertical_margin_) / py_delta_ + y_min_;
+				auto x_val = floor((x - px_start_ - margins.x) / px_delta_ + x_min_ + 0.05);
+				auto y_val = (extent_.height - y - margins.y) / py_delta_ + y_min_;
 				std::ostringstream oss;
 				oss << "T(" << x_val << ", " << y_val << ")";
 				return oss.str();
 			}
 			case 2:
 			{
-				auto x_val = (x - px_start_ - horizontal_margin_) / px_delta_ + x_min_;
-				auto y_val = (size_.height - y - py_start_ - vertical_margin_) / py_delta_ + y_min_;
+				auto x_val = (x - px_start_ - margins.x) / px_delta_ + x_min_;
+				auto y_val = (extent_.height - y - py_start_ - margins.y) / py_delta_ + y_min_;
 				std::ostringstream oss;
 				oss << "P(" << x_val << ", " << y_val << ")";
 				return oss.str();
 			}
 			case 3:
 			{
-				auto x_val = (int)((x - px_start_ - horizontal_margin_) / px_delta_ + x_min_ + 0.5);
-				auto y_val = (int)((size_.height - y - py_start_ - vertical_margin_) / py_delta_ + y_min_ + 0.5);
+				auto x_val = (int)((x - px_start_ - margins.x) / px_delta_ + x_min_ + 0.5);
+				auto y_val = (int)((extent_.height - y - py_start_ - margins.y) / py_delta_ + y_min_ + 0.5);
 				std::ostringstream oss;
 				oss << "R(" << x_val << ", " << y_val << ")";
 				return oss.str();
@@ -1591,9 +6924,10 @@ namespace cvplot
 			return text_color_;
 		}
 
+		//! a lazily loaded view is valid before its buffer gets allocated
 		bool IsValid() const
 		{
-			return !buffer_.empty();
+			return !buffer_.empty() || (size_.width > 0 && size_.height > 0);
 		}
 
 		bool IsDirty() const
@@ -1601,6 +6935,13 @@ namespace cvplot
 			return dirty_;
 		}
 
+		//! quality of the last render, quality::Draft until refined
+		quality::Type GetQuality() const
+		{
+			return quality_;
+		}
+
+		//! a private copy of the last render, see GetFrame
 		cv::Mat GetBuffer() const
 		{
 			if (buffer_.empty())
@@ -1611,96 +6952,392 @@ namespace cvplot
 			return buffer_.clone();
 		}
 
-		void Dump(const std::string& prefix)
+		//! the last render without copying. read-only: the pixels are shared with the view,
+		//! the next Render draws into a new buffer while the frame is held
+		cv::Mat GetFrame() const
 		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, (prefix + ".000000000.vdp").c_str(), "w");
+			return buffer_;
+		}
+
+		//! bytes held by the frame and the series
+		size_t GetMemory() const
+		{
+			std::set<const void*> counted;
+			return GetMemory_(counted);
+		}
+
+		void Dump(const std::string& prefix, dump::Encoding encoding = dump::Raw)
+		{
+			std::vector<std::function<void()>> tasks;
+			Dump_(prefix, encoding, tasks);
+			util::ParallelFor(tasks.size(), [&tasks](size_t i) { tasks[i](); });
+		}
+
+		//! like Dump, but every series only appends what changed since its last checkpoint
+		void Checkpoint(const std::string& prefix)
+		{
+			std::vector<std::function<void()>> tasks;
+			Dump_(prefix, CHECKPOINT, tasks);
+			util::ParallelFor(tasks.size(), [&tasks](size_t i) { tasks[i](); });
+		}
+
+	private:
+		//! pseudo encoding used by Checkpoint
+		static const dump::Encoding CHECKPOINT = -1;
+
+		//! write the view metadata and queue one task per series, the tasks refer to
+		//! the series in place and must run before the view is modified
+		void Dump_(const std::string& prefix, dump::Encoding encoding, std::vector<std::function<void()>>& tasks)
+		{
+			Materialize();
+			FILE* fp = util::OpenFile(prefix + ".000000000.vdp", "w");
 			if (fp)
 			{
-				fprintf_s(fp, "title=%s\n", title_.c_str());
-				fprintf_s(fp, "%d %d\n", size_.width, size_.height);
-				fprintf_s(fp, "xlabel=%s\n", xlabel_.c_str());
-				fprintf_s(fp, "ylabel=%s\n", ylabel_.c_str());
+				fprintf(fp, "title=%s\n", title_.c_str());
+				fprintf(fp, "%d %d\n", size_.width, size_.height);
+				fprintf(fp, "xlabel=%s\n", xlabel_.c_str());
+				fprintf(fp, "ylabel=%s\n", ylabel_.c_str());
 				auto vec4 = background_color_.ToVec4b();
-				fprintf_s(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
+				fprintf(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
 				vec4 = text_color_.ToVec4b();
-				fprintf_s(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
+				fprintf(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
 				vec4 = grid_color_.ToVec4b();
-				fprintf_s(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
-				fprintf_s(fp, "%d\n", enable_grid_ ? 1 : 0);
-				fprintf_s(fp, "%d %d\n", horizontal_margin_, vertical_margin_);
+				fprintf(fp, "%d %d %d %d\n", vec4[0], vec4[1], vec4[2], vec4[3]);
+				fprintf(fp, "%d\n", enable_grid_ ? 1 : 0);
+				fprintf(fp, "%d %d\n", horizontal_margin_, vertical_margin_);
 				int n = series_map_.size();
-				fprintf_s(fp, "%d\n", n);
+				fprintf(fp, "%d\n", n);
 				int index = 0;
-				for (auto s : series_map_)
+				for (auto& s : series_map_)
 				{
 					char sz[32] = { 0 };
-					sprintf_s(sz, ".%09d.sdp", ++index);
+					snprintf(sz, sizeof(sz), ".%09d.sdp", ++index);
 					auto filename = prefix + sz;
-					s.second.Dump(filename);
-					s.second.DumpText(filename + ".txt");
-					s.second.DumpBinary(filename + ".bin");
-					fprintf_s(fp, "%s\n", filename.c_str());
+					auto series = &s.second;
+					tasks.push_back([series, filename, encoding]() { DumpSeries_(*series, filename, encoding); });
+					fprintf(fp, "%s\n", filename.c_str());
 				}
 				fclose(fp);
 			}
 		}
 
-		View& Load(const std::string prefix, const bool filterInfNaN)
+		static void DumpSeries_(Series& s, const std::string& filename, dump::Encoding encoding)
 		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, (prefix + ".000000000.vdp").c_str(), "r");
-			if (fp)
+			if (encoding == CHECKPOINT)
+			{
+				s.Checkpoint(filename);
+				return;
+			}
+
+			s.Dump(filename, encoding);
+			if (encoding == dump::Gorilla)
+			{
+				s.DumpCompressed(filename + ".gor");
+			}
+			else
+			{
+				s.DumpText(filename + ".txt");
+				s.DumpBinary(filename + ".bin");
+			}
+		}
+
+		//! read the view metadata (clearing the series) and return the series files,
+		//! a lazy load keeps the buffer unallocated until Materialize
+		std::vector<std::string> LoadMeta_(const std::string& prefix, const bool lazy = false)
+		{
+			FILE* fp = util::OpenFile(prefix + ".000000000.vdp", "r");
+			if (fp == nullptr)
+			{
+				throw std::runtime_error("failed to load view");
+			}
+
+			std::string line;
+			util::ReadLine(fp, line);
+			title_ = line.substr(std::min<size_t>(6, line.size())); //! cut "title="
+			int width;
+			int height;
+			util::ScanFile(fp, "%d %d\n", &width, &height);
+			if (lazy)
+			{
+				buffer_.release();
+				size_ = ClampSize_({ width,height });
+				dirty_ = true;
+			}
+			else
+			{
+				SetSize({ width,height });
+			}
+			util::ReadLine(fp, line);
+			xlabel_ = line.substr(std::min<size_t>(7, line.size())); //! cut "xlabel="
+			util::ReadLine(fp, line);
+			ylabel_ = line.substr(std::min<size_t>(7, line.size())); //! cut "ylabel="
+			int r, g, b, a;
+			util::ScanFile(fp, "%d %d %d %d\n", &b, &g, &r, &a);
+			auto color1 = Color(r, g, b, a);
+			background_color_ = color1;
+			util::ScanFile(fp, "%d %d %d %d\n", &b, &g, &r, &a);
+			auto color2 = Color(r, g, b, a);
+			text_color_ = color2;
+			util::ScanFile(fp, "%d %d %d %d\n", &b, &g, &r, &a);
+			auto color3 = Color(r, g, b, a);
+			grid_color_ = color3;
+			int enable;
+			util::ScanFile(fp, "%d\n", &enable);
+			enable_grid_ = enable > 0;
+			util::ScanFile(fp, "%d %d\n", &horizontal_margin_, &vertical_margin_);
+			int n;
+			util::ScanFile(fp, "%d\n", &n);
+			Clear();
+			std::vector<std::string> filenames;
+			for (int i = 0; i < n; ++i)
+			{
+				util::ReadLine(fp, line);
+				filenames.push_back(line);
+			}
+			fclose(fp);
+			return filenames;
+		}
+
+		static void LoadSeries_(Series& s, const std::string& filename, const bool filterInfNaN, const bool mapped)
+		{
+			s.Load(filename);
+			if (s.GetStoredEncoding() == dump::Gorilla)
+			{
+				s.LoadCompressed(filename + ".gor", filterInfNaN);
+			}
+			else
+			{
+				s.LoadBinary(filename + ".bin", filterInfNaN, mapped);
+			}
+			if (s.HasJournal())
+			{
+				s.ReplayJournal(filename + ".jnl", filterInfNaN);
+			}
+		}
+
+		//! add series holding only their metadata, the data is loaded by SelectSeries or Materialize
+		void LoadPending_(const std::vector<std::string>& filenames, const bool filterInfNaN, const bool mapped)
+		{
+			for (auto& filename : filenames)
 			{
-				const int LEN = 256;
-				char sz[LEN] = { 0 };
-				fscanf_s(fp, "%[^\n]", sz, LEN);
-				title_ = std::string(sz).substr(6); //! cut "title="
-				int width;
-				int height;
-				fscanf_s(fp, "%d %d\n", &width, &height);
+				Series s;
+				s.Load(filename);
+				auto label = s.GetLabel();
+				AddSeries(std::move(s));
+				pending_[label] = filename;
+			}
+			pending_filter_ = filterInfNaN;
+			pending_mapped_ = mapped;
+		}
+
+	public:
+		//! lazy: read the .vdp/.sdp metadata only, see Materialize.
+		//! a pack (see Figure::DumpPack) given as prefix loads its first sub-plot
+		View& Load(const std::string prefix, const bool filterInfNaN, const bool mapped = false, const bool lazy = false)
+		{
+			if (pack::IsPack(prefix))
+			{
+				return LoadPack(prefix, 1, 1, filterInfNaN, mapped);
+			}
+
+			auto filenames = LoadMeta_(prefix, lazy);
+			if (lazy)
+			{
+				LoadPending_(filenames, filterInfNaN, mapped);
+				return *this;
+			}
+
+			std::vector<Series> loaded(filenames.size());
+			util::ParallelFor(loaded.size(), [&](size_t i)
+			{
+				LoadSeries_(loaded[i], filenames[i], filterInfNaN, mapped);
+			});
+			for (auto& s : loaded)
+			{
+				AddSeries(std::move(s));
+			}
+			return *this;
+		}
+
+		void DumpPack(pack::Writer& writer, uint32_t index)
+		{
+			Materialize();
+			pack::Buffer buffer;
+			buffer.PutString(title_)
+				.PutInt(size_.width)
+				.PutInt(size_.height)
+				.PutString(xlabel_)
+				.PutString(ylabel_)
+				.PutColor(background_color_)
+				.PutColor(text_color_)
+				.PutColor(grid_color_)
+				.PutInt(enable_grid_ ? 1 : 0)
+				.PutInt(horizontal_margin_)
+				.PutInt(vertical_margin_)
+				.PutInt((int32_t)series_map_.size());
+			writer.Write(pack::block::View, index, 0, buffer);
+
+			uint32_t series = 0;
+			for (auto& s : series_map_)
+			{
+				s.second.DumpPack(writer, index, ++series);
+			}
+		}
+
+		//! consume one block of a pack, a series is added as soon as its data block arrives
+		View& LoadPack(pack::Reader& reader, const pack::BlockHeader& header, Series& pending, const bool filterInfNaN)
+		{
+			switch (header.kind)
+			{
+			case pack::block::View:
+			{
+				auto buffer = reader.ReadBuffer(header);
+				title_ = buffer.GetString();
+				int width = buffer.GetInt();
+				int height = buffer.GetInt();
 				SetSize({ width,height });
-				char sz1[LEN] = { 0 };
-				fscanf_s(fp, "%[^\n]\n", sz1, LEN);
-				xlabel_ = std::string(sz1).substr(7); //! cut "xlabel="
-				char sz2[LEN] = { 0 };
-				fscanf_s(fp, "%[^\n]", sz2, LEN);
-				ylabel_ = std::string(sz2).substr(7); //! cut "ylabel="
-				int r, g, b, a;
-				fscanf_s(fp, "%d %d %d %d\n", &b, &g, &r, &a);
-				auto color1 = Color(r, g, b, a);
+				xlabel_ = buffer.GetString();
+				ylabel_ = buffer.GetString();
+				auto color1 = buffer.GetColor();
 				background_color_ = color1;
-				fscanf_s(fp, "%d %d %d %d\n", &b, &g, &r, &a);
-				auto color2 = Color(r, g, b, a);
+				auto color2 = buffer.GetColor();
 				text_color_ = color2;
-				fscanf_s(fp, "%d %d %d %d\n", &b, &g, &r, &a);
-				auto color3 = Color(r, g, b, a);
+				auto color3 = buffer.GetColor();
 				grid_color_ = color3;
-				int enable;
-				fscanf_s(fp, "%d\n", &enable);
-				enable_grid_ = enable > 0;
-				fscanf_s(fp, "%d %d\n", &horizontal_margin_, &vertical_margin_);
-				int n;
-				fscanf_s(fp, "%d\n", &n);
+				enable_grid_ = buffer.GetInt() > 0;
+				horizontal_margin_ = buffer.GetInt();
+				vertical_margin_ = buffer.GetInt();
 				Clear();
-				for (int i = 0; i < n; ++i)
+			}
+			break;
+			case pack::block::Series:
+				pending.LoadPack(reader, header, filterInfNaN);
+				break;
+			case pack::block::Data:
+				pending.LoadPack(reader, header, filterInfNaN);
+				AddSeries(pending);
+				break;
+			default:
+				break;
+			}
+			dirty_ = true;
+			return *this;
+		}
+
+		//! load a single sub-plot from a pack written by Figure::DumpPack
+		View& LoadPack(const std::string& filename, int row, int col, const bool filterInfNaN = true, const bool mapped = false)
+		{
+			pack::Reader reader(filename, mapped);
+			auto toc = reader.GetTableOfContents();
+			if (toc.empty() || toc[0].kind != pack::block::Figure)
+			{
+				throw std::runtime_error("invalid pack");
+			}
+
+			auto buffer = reader.ReadBuffer(toc[0]);
+			buffer.GetString(); //! figure name
+			int rows = buffer.GetInt();
+			int cols = buffer.GetInt();
+			if (row < 1 || row > rows || col < 1 || col > cols)
+			{
+				throw std::out_of_range("view index out of range");
+			}
+
+			uint32_t index = (row - 1) * cols + col - 1;
+			Series pending;
+			for (auto& header : toc)
+			{
+				if (header.kind != pack::block::Figure && header.view == index)
 				{
-					char szf[LEN] = { 0 };
-					fscanf_s(fp, "%s\n", szf, LEN);
-					Series s;
-					s.Load(szf);
-					strcat_s(szf, ".bin");
-					s.LoadBinary(szf, filterInfNaN);
-					AddSeries(s);
+					LoadPack(reader, header, pending, filterInfNaN);
 				}
-				fclose(fp);
-				return *this;
 			}
+			return *this;
+		}
+
+	private:
+		size_t GetMemory_(std::set<const void*>& counted) const
+		{
+			size_t bytes = util::FrameBytes(buffer_, counted);
+			for (auto& s : series_map_)
+			{
+				bytes += s.second.GetMemory();
+			}
+			return bytes;
+		}
+
+		//! everything operator= transfers except the series
+		void Assign_(const View& rhs)
+		{
+			title_ = rhs.title_;
+			size_ = rhs.size_;
+			xlabel_ = rhs.xlabel_;
+			ylabel_ = rhs.ylabel_;
+			background_color_ = rhs.background_color_;
+			text_color_ = rhs.text_color_;
+			enable_grid_ = rhs.enable_grid_;
+			grid_color_ = rhs.grid_color_;
+			horizontal_margin_ = rhs.horizontal_margin_;
+			vertical_margin_ = rhs.vertical_margin_;
+			buffer_ = rhs.buffer_; //! shared until either side renders
+			sources_ = rhs.sources_;
+			pending_filter_ = rhs.pending_filter_;
+			pending_mapped_ = rhs.pending_mapped_;
+			has_viewport_ = rhs.has_viewport_;
+			auto_y_ = rhs.auto_y_;
+			std::copy(rhs.viewport_, rhs.viewport_ + 4, viewport_);
+			profiling_ = rhs.profiling_;
+			trace_ = rhs.trace_;
+			render_size_ = rhs.render_size_;
+			extent_ = rhs.size_;
+			dirty_ = true;
+			x_min_ = 0;
+			y_min_ = 0;
+			x_max_ = 1;
+			y_max_ = 1;
+			px_start_ = 0;
+			px_delta_ = 1;
+			py_start_ = 0;
+			py_delta_ = 1;
+			dimension_ = rhs.dimension_;
+		}
+
+		//! views below this leave no room for the plot between the margins
+		cv::Size ClampSize_(cv::Size size) const
+		{
+			const int MIN_PLOT = 100;
+			return
+			{
+				std::max(size.width, 2 * horizontal_margin_ + MIN_PLOT),
+				std::max(size.height, 2 * vertical_margin_ + MIN_PLOT)
+			};
+		}
+
+		//! render pixels per GetSize pixel, 1 for views without a size (rendered by a figure)
+		cv::Point2d Scale_(cv::Size extent) const
+		{
+			if (size_.width <= 0 || size_.height <= 0)
+			{
+				return { 1.0, 1.0 };
+			}
+			return { (double)extent.width / size_.width, (double)extent.height / size_.height };
+		}
 
-			throw std::exception("failed to load view");
+		//! margins of a render laid out over extent
+		cv::Point Margins_(cv::Size extent) const
+		{
+			auto scale = Scale_(extent);
+			return { (int)(horizontal_margin_ * scale.x + 0.5), (int)(vertical_margin_ * scale.y + 0.5) };
+		}
+
+		//! GetSize coordinates to the pixels of the last render
+		void ToExtent_(double& x, double& y) const
+		{
+			auto scale = Scale_(extent_);
+			x *= scale.x;
+			y *= scale.y;
 		}
 
-	private:
 		static double CalcSnap_(double value)
 		{
 			auto v1 = pow(10, floor(log10(value)));
@@ -1723,6 +7360,10 @@ namespace cvplot
 		int horizontal_margin_;
 		int vertical_margin_;
 		std::map<std::string, Series> series_map_;
+		std::map<std::string, std::string> pending_; //! label -> .sdp of series not loaded yet
+		std::vector<std::weak_ptr<live::Source>> sources_;
+		bool pending_filter_;
+		bool pending_mapped_;
 		double x_min_;
 		double y_min_;
 		double px_start_;
@@ -1730,6 +7371,17 @@ namespace cvplot
 		double px_delta_;
 		double py_delta_;
 		int dimension_;
+		double x_max_;
+		double y_max_;
+		bool has_viewport_;
+		bool auto_y_;        //! y of the viewport fits the data in [x0, x1]
+		double viewport_[4]; //! x0, x1, y0, y1 when has_viewport_
+		bool profiling_;
+		std::shared_ptr<profile::Trace> trace_;
+		profile::ViewStats render_stats_;
+		cv::Size render_size_; //! SetRenderSize, {0,0} renders at size_
+		cv::Size extent_;      //! pixels the last render laid out, see ToExtent_
+		quality::Type quality_;
 	};
 
 	class IMouseMove
@@ -1737,6 +7389,23 @@ namespace cvplot
 	public:
 		virtual void OnMouseMove(int x, int y, std::string& window_name) = 0;
 		virtual void ResetMouseMove(std::string& window_name) = 0;
+
+		//! delta > 0 when the wheel goes forward
+		virtual void OnMouseWheel(int /*x*/, int /*y*/, int /*delta*/, std::string& /*window_name*/)
+		{
+			//
+		}
+
+		//! left button held down, (dx, dy) since the previous drag event
+		virtual void OnMouseDrag(int /*x*/, int /*y*/, int /*dx*/, int /*dy*/, std::string& /*window_name*/)
+		{
+			//
+		}
+
+		virtual void OnMouseDoubleClick(int /*x*/, int /*y*/, std::string& /*window_name*/)
+		{
+			//
+		}
 	};
 
 	namespace mouse
@@ -1746,6 +7415,9 @@ namespace cvplot
 		static int y__ = INT_MAX;
 		static int x_max__ = INT_MAX;
 		static int y_max__ = INT_MAX;
+		static bool drag__ = false;
+		static int drag_x__ = 0;
+		static int drag_y__ = 0;
 
 		static void update_window(std::string& name, cv::Size& size)
 		{
@@ -1756,6 +7428,40 @@ namespace cvplot
 
 		static void event_handler(int event, int x, int y, int flags, void* param)
 		{
+			auto p = reinterpret_cast<IMouseMove*>(param);
+			switch (event)
+			{
+			case cv::EVENT_MOUSEWHEEL:
+				p->OnMouseWheel(x, y, cv::getMouseWheelDelta(flags), window_name__);
+				return;
+			case cv::EVENT_LBUTTONDOWN:
+				drag__ = true;
+				drag_x__ = x;
+				drag_y__ = y;
+				return;
+			case cv::EVENT_LBUTTONUP:
+				drag__ = false;
+				return;
+			case cv::EVENT_LBUTTONDBLCLK:
+				drag__ = false;
+				p->OnMouseDoubleClick(x, y, window_name__);
+				return;
+			default:
+				break;
+			}
+
+			if (event == cv::EVENT_MOUSEMOVE && drag__ && (flags & cv::EVENT_FLAG_LBUTTON))
+			{
+				auto dx = x - drag_x__;
+				auto dy = y - drag_y__;
+				drag_x__ = x;
+				drag_y__ = y;
+				if (dx != 0 || dy != 0)
+				{
+					p->OnMouseDrag(x, y, dx, dy, window_name__);
+				}
+			}
+
 			if (event == cv::EVENT_MOUSEMOVE
 				&& (abs(x__ - x) > 0 || abs(y__ - y) > 0))
 			{
@@ -1769,7 +7475,6 @@ namespace cvplot
 				x__ = x;
 				y__ = y;
 
-				auto p = reinterpret_cast<IMouseMove*>(param);
 				if (reset)
 				{
 					p->ResetMouseMove(window_name__);
@@ -1782,6 +7487,379 @@ namespace cvplot
 		}
 	}
 
+	namespace metric
+	{
+		//! interned metric name, see Intern
+		typedef uint32_t Id;
+
+		//! raw timestamp: the TSC on x86, steady_clock nanoseconds elsewhere
+		static inline uint64_t Ticks()
+		{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+			return __builtin_ia32_rdtsc();
+#else
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+
+		namespace detail
+		{
+			struct Sample
+			{
+				Id id;
+				uint64_t ticks;
+				double value;
+			};
+
+			//! single producer (the recording thread), single consumer (the flusher)
+			struct Ring
+			{
+				static const size_t CAPACITY = 1 << 16;
+
+				alignas(64) std::atomic<size_t> head{ 0 };
+				size_t cached_tail = 0;
+				std::atomic<uint64_t> dropped{ 0 };
+				alignas(64) std::atomic<size_t> tail{ 0 };
+				std::atomic<bool> retired{ false };
+				Sample samples[CAPACITY];
+			};
+
+			struct Registry
+			{
+				std::mutex mtx;
+				std::map<std::string, Id> ids;
+				std::vector<std::string> names;
+				std::vector<std::shared_ptr<Ring>> rings;
+				std::mutex consume_mtx; //! the rings have one consumer: one Flusher collects at a time
+				int consumers = 0;      //! live Flushers
+				uint64_t dropped = 0;   //! by the rings released so far
+			};
+
+			//! inline, not static: one registry per program even with several translation units
+			inline Registry& GetRegistry()
+			{
+				static Registry registry;
+				return registry;
+			}
+
+			struct Local
+			{
+				static const int CACHE_SIZE = 64;
+
+				std::shared_ptr<Ring> ring;
+				const char* keys[CACHE_SIZE] = {};
+				Id ids[CACHE_SIZE] = {};
+
+				Local() : ring(std::make_shared<Ring>())
+				{
+					auto& registry = GetRegistry();
+					std::lock_guard<std::mutex> lock(registry.mtx);
+					registry.rings.push_back(ring);
+				}
+
+				~Local()
+				{
+					auto& registry = GetRegistry();
+					std::lock_guard<std::mutex> consume(registry.consume_mtx);
+					std::lock_guard<std::mutex> lock(registry.mtx);
+					if (registry.consumers > 0 && ring->tail.load() != ring->head.load())
+					{
+						ring->retired = true; //! a flusher drains and releases it
+						return;
+					}
+
+					//! drained, or no flusher to ever drain it
+					registry.dropped += ring->dropped.load();
+					auto& rings = registry.rings;
+					rings.erase(std::remove(rings.begin(), rings.end(), ring), rings.end());
+				}
+			};
+
+			inline Local& GetLocal()
+			{
+				thread_local Local local;
+				return local;
+			}
+		}
+
+		//! map a metric name to its id, do it once outside the hot loop
+		static Id Intern(const std::string& name)
+		{
+			auto& registry = detail::GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mtx);
+			auto iter = registry.ids.find(name);
+			if (iter != registry.ids.end())
+			{
+				return iter->second;
+			}
+			auto id = (Id)registry.names.size();
+			registry.names.push_back(name);
+			registry.ids.insert({ name, id });
+			return id;
+		}
+
+		static std::string GetName(Id id)
+		{
+			auto& registry = detail::GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mtx);
+			return id < registry.names.size() ? registry.names[id] : std::string();
+		}
+
+		//! append a timestamped sample to the calling thread's buffer, a full buffer
+		//! drops the sample (counted) instead of waiting for the flusher
+		static inline void Record(Id id, double value)
+		{
+			auto& ring = *detail::GetLocal().ring;
+			auto head = ring.head.load(std::memory_order_relaxed);
+			if (head - ring.cached_tail >= detail::Ring::CAPACITY)
+			{
+				ring.cached_tail = ring.tail.load(std::memory_order_acquire);
+				if (head - ring.cached_tail >= detail::Ring::CAPACITY)
+				{
+					ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+					return;
+				}
+			}
+			auto& sample = ring.samples[head & (detail::Ring::CAPACITY - 1)];
+			sample.id = id;
+			sample.ticks = Ticks();
+			sample.value = value;
+			ring.head.store(head + 1, std::memory_order_release);
+		}
+
+		//! name must be a string literal (or outlive the thread): ids are cached per thread by address
+		static inline void Record(const char* name, double value)
+		{
+			auto& local = detail::GetLocal();
+			auto slot = ((uintptr_t)name >> 3) & (detail::Local::CACHE_SIZE - 1);
+			if (local.keys[slot] != name)
+			{
+				local.ids[slot] = Intern(name);
+				local.keys[slot] = name;
+			}
+			Record(local.ids[slot], value);
+		}
+
+		//! moves recorded samples into one live series per metric of the views it is added to
+		//! (View::AddSource). x is milliseconds since the flusher started for 2-d chart types
+		class Flusher : public live::Source
+		{
+		public:
+			Flusher(chart::Type chartType = chart::Line, int intervalMs = 50, size_t capacity = 1 << 16)
+				: chart_type_(chartType),
+				interval_(intervalMs),
+				capacity_(capacity),
+				running_(true),
+				start_ticks_(Ticks()),
+				start_time_(std::chrono::steady_clock::now()),
+				ticks_per_ms_(0)
+			{
+				auto dimension = chart::GetDimension(chartType);
+				if (dimension != 1 && dimension != 2)
+				{
+					throw std::invalid_argument("metrics need a 1-d or 2-d chart type");
+				}
+				{
+					auto& registry = detail::GetRegistry();
+					std::lock_guard<std::mutex> lock(registry.mtx);
+					++registry.consumers;
+				}
+				thread_ = std::thread([this]() { Run_(); });
+			}
+
+			~Flusher()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					running_ = false;
+				}
+				cv_.notify_all();
+				thread_.join();
+
+				//! the last flusher releases the rings of exited threads, nobody drains them now
+				auto& registry = detail::GetRegistry();
+				std::lock_guard<std::mutex> consume(registry.consume_mtx);
+				std::lock_guard<std::mutex> lock(registry.mtx);
+				if (--registry.consumers == 0)
+				{
+					auto& rings = registry.rings;
+					for (auto iter = rings.begin(); iter != rings.end();)
+					{
+						if ((*iter)->retired)
+						{
+							registry.dropped += (*iter)->dropped.load();
+							iter = rings.erase(iter);
+						}
+						else
+						{
+							++iter;
+						}
+					}
+				}
+			}
+
+			//! collect right away instead of waiting for the next period. the thread buffers
+			//! are shared, several flushers take turns and split the samples between them
+			void Flush()
+			{
+				std::lock_guard<std::mutex> lock(detail::GetRegistry().consume_mtx);
+				Collect_();
+			}
+
+			//! samples lost to full thread buffers or full series queues
+			uint64_t GetDropped() const
+			{
+				uint64_t dropped = 0;
+				{
+					auto& registry = detail::GetRegistry();
+					std::lock_guard<std::mutex> lock(registry.mtx);
+					dropped += registry.dropped;
+					for (auto& ring : registry.rings)
+					{
+						dropped += ring->dropped.load(std::memory_order_relaxed);
+					}
+				}
+				std::lock_guard<std::mutex> lock(mtx_);
+				for (auto& entry : queues_)
+				{
+					dropped += entry.second.queue->GetStats().dropped;
+				}
+				return dropped;
+			}
+
+			void Feed(View& view) override;
+
+		private:
+			void Run_()
+			{
+				std::unique_lock<std::mutex> lock(mtx_);
+				while (running_)
+				{
+					cv_.wait_for(lock, std::chrono::milliseconds(interval_));
+					lock.unlock();
+					Flush();
+					lock.lock();
+				}
+			}
+
+			void Collect_()
+			{
+				std::vector<std::shared_ptr<detail::Ring>> rings;
+				{
+					auto& registry = detail::GetRegistry();
+					std::lock_guard<std::mutex> lock(registry.mtx);
+					rings = registry.rings;
+				}
+
+				//! calibrate ticks against the steady clock over the whole run
+				auto now_ticks = Ticks();
+				auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time_).count();
+				if (elapsed > 1 && now_ticks > start_ticks_)
+				{
+					ticks_per_ms_ = (now_ticks - start_ticks_) / elapsed;
+				}
+				auto ticks_per_ms = ticks_per_ms_ > 0 ? ticks_per_ms_ : 1e6;
+
+				bool retired = false;
+				for (auto& ring : rings)
+				{
+					bool done = ring->retired.load(std::memory_order_acquire);
+					auto tail = ring->tail.load(std::memory_order_relaxed);
+					auto head = ring->head.load(std::memory_order_acquire);
+					for (; tail != head; ++tail)
+					{
+						auto& sample = ring->samples[tail & (detail::Ring::CAPACITY - 1)];
+						auto& queue = GetQueue_(sample.id);
+						bool ok = queue.GetDimension() == 1
+							? queue.Push(sample.value)
+							: queue.Push(((int64_t)(sample.ticks - start_ticks_)) / ticks_per_ms, sample.value);
+						(void)ok;
+					}
+					ring->tail.store(tail, std::memory_order_release);
+					retired = retired || done;
+				}
+
+				if (retired)
+				{
+					auto& registry = detail::GetRegistry();
+					std::lock_guard<std::mutex> lock(registry.mtx);
+					auto& all = registry.rings;
+					for (auto iter = all.begin(); iter != all.end();)
+					{
+						auto& ring = *iter;
+						if (ring->retired && ring->tail.load() == ring->head.load())
+						{
+							registry.dropped += ring->dropped.load();
+							iter = all.erase(iter);
+						}
+						else
+						{
+							++iter;
+						}
+					}
+				}
+			}
+
+			live::Queue& GetQueue_(Id id)
+			{
+				if (id < cache_.size() && cache_[id])
+				{
+					return *cache_[id];
+				}
+
+				auto name = GetName(id);
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto& entry = queues_[id];
+				if (!entry.queue)
+				{
+					entry.name = name;
+					entry.queue = std::make_shared<live::Queue>(chart_type_ == chart::Histogram ? 1 : chart::GetDimension(chart_type_), capacity_);
+				}
+				auto& queue = entry.queue;
+				if (cache_.size() <= id)
+				{
+					cache_.resize(id + 1);
+				}
+				cache_[id] = queue;
+				return *queue;
+			}
+
+			chart::Type chart_type_;
+			int interval_;
+			size_t capacity_;
+			bool running_;
+			uint64_t start_ticks_;
+			std::chrono::steady_clock::time_point start_time_;
+			double ticks_per_ms_;
+			struct Entry
+			{
+				std::string name;
+				std::shared_ptr<live::Queue> queue;
+			};
+
+			mutable std::mutex mtx_;         //! queues_, running_
+			std::condition_variable cv_;
+			std::map<Id, Entry> queues_;
+			std::vector<std::shared_ptr<live::Queue>> cache_; //! under the registry consume_mtx
+			std::thread thread_;
+		};
+
+		inline void Flusher::Feed(View& view)
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			for (auto& entry : queues_)
+			{
+				if (!view.FindSeries(entry.second.name))
+				{
+					view.AddSeries(Series(entry.second.name, chart_type_).SetLive(entry.second.queue));
+				}
+			}
+		}
+	}
+
 	class Figure : public IMouseMove
 	{
 	public:
@@ -1794,11 +7872,19 @@ namespace cvplot
 			view_size_({ 0,0 }),
 			background_color_(color::Gray),
 			buffer_(800, 800, CV_8UC4, background_color_.ToScalar()),
-			enable_mouse_move_(false)
+			enable_mouse_move_(false),
+			enable_zoom_pan_(false),
+			live_window_(false),
+			hover_({ -1, -1 }),
+			hover_pending_(false),
+			pumping_(false),
+			profiling_(false),
+			supersampling_(1),
+			progressive_(false)
 		{
 			int index = autoIndex ? util::GetUniqueWindowIndex() : 0;
 			char sz[16] = { 0 };
-			sprintf_s(sz, "fig-%09d", index);
+			snprintf(sz, sizeof(sz), "fig-%09d", index);
 			figure_name_ = sz;
 			views_.push_back(View());
 
@@ -1824,6 +7910,7 @@ namespace cvplot
 				auto tmp = cv::Mat(figure_size_, CV_8UC4, Color(200, 200, 200, 128).ToScalar());
 				cv::resize(buffer_, tmp, figure_size_, 0, 0, cv::INTER_NEAREST);
 				buffer_ = tmp;
+				composed_.clear();
 
 				auto res_width = figure_size_.width - (total_cols_ + 1) * horizontal_margin_;
 				auto res_height = figure_size_.height - (total_rows_ + 1) * vertical_margin_;
@@ -1836,106 +7923,218 @@ namespace cvplot
 			return *this;
 		}
 
-		Figure& SetLayout(int rows, int cols)
+		Figure& SetLayout(int rows, int cols)
+		{
+			int count_ = total_rows_ * total_cols_;
+			int count = rows * cols;
+			if (count_ != count)
+			{
+				views_.resize(count, View("", { 800,800 }));
+			}
+
+			total_rows_ = rows;
+			total_cols_ = cols;
+			composed_.clear();
+
+			//! the slots must fit the composite, buffer_(roi) is written in place
+			auto res_width = figure_size_.width - (total_cols_ + 1) * horizontal_margin_;
+			auto res_height = figure_size_.height - (total_rows_ + 1) * vertical_margin_;
+			view_size_ =
+			{
+				res_width / total_cols_,
+				res_height / total_rows_
+			};
+			return *this;
+		}
+
+		Figure& SetView(View& view, int row, int col)
+		{
+			if (row < 0 || col < 0)
+			{
+				throw std::out_of_range("view index out of range");
+			}
+
+			int index = (row - 1) * total_cols_ + col - 1;
+			if (index < 0 || index >= views_.size())
+			{
+				throw std::out_of_range("view index out of range");
+			}
+			views_[index] = std::move(view); //! the view hands its series over
+			return *this;
+		}
+
+		View& SelectView(int row, int col)
+		{
+			int index = (row - 1) * total_cols_ + col - 1;
+			if (index < 0 || index >= views_.size())
+			{
+				throw std::out_of_range("view index out of range");
+			}
+
+			return views_[index];
+		}
+
+		void Show(std::string title, bool waitKey = true)
+		{
+			Render_();
+			OpenWindow_(title);
+			if (waitKey)
+			{
+				if (enable_mouse_move_ || enable_zoom_pan_)
+				{
+					//! ~60 Hz pump so hover updates and zoom/pan re-renders are coalesced per frame
+					pumping_ = true;
+					while (cv::waitKey(16) < 0 && cv::getWindowProperty(title, cv::WND_PROP_VISIBLE) >= 1)
+					{
+						bool changed = RenderProgressive_();
+						if (DrawHover_() || changed)
+						{
+							cv::imshow(title, buffer_);
+						}
+					}
+					pumping_ = false;
+				}
+				else
+				{
+					cv::waitKey();
+				}
+				cv::destroyWindow(title);
+			}
+		}
+
+		void Show(bool waitKey = true)
+		{
+			Show(figure_name_, waitKey);
+		}
+
+		//! one frame of a live display: drain and re-render the dirty views, imshow only if
+		//! the composite changed, then pump window events for waitMs (at least 1).
+		//! returns the key pressed or -1
+		int Poll(int waitMs = 1)
+		{
+			Refresh();
+			return cv::waitKey(std::max(1, waitMs));
+		}
+
+		//! Poll without pumping window events
+		void Refresh()
+		{
+			auto start = std::chrono::steady_clock::now();
+			Present_();
+			FinishFrame_(start, 0);
+		}
+
+		//! live display at a target frame rate: update (may be empty) is called before every
+		//! frame, the loop ends when it returns false, on ESC or when the window is closed
+		void RunLive(double fps, std::function<bool(Figure&)> update)
 		{
-			int count_ = total_rows_ * total_cols_;
-			int count = rows * cols;
-			if (count_ != count)
+			auto budget = 1000.0 / std::max(1.0, fps);
+			for (;;)
 			{
-				views_.resize(count, View("", { 800,800 }));
+				auto start = std::chrono::steady_clock::now();
+				if (update && !update(*this))
+				{
+					break;
+				}
+				Present_();
+				auto elapsed = FinishFrame_(start, budget);
+
+				auto key = cv::waitKey(std::max(1, (int)(budget - elapsed)));
+				if (key == 27 || cv::getWindowProperty(figure_name_, cv::WND_PROP_VISIBLE) < 1)
+				{
+					break;
+				}
 			}
+		}
 
-			total_rows_ = rows;
-			total_cols_ = cols;
-			return *this;
+		live::FrameStats GetFrameStats() const
+		{
+			return frame_stats_;
 		}
 
-		Figure& SetView(View& view, int row, int col)
+		//! time the composite stages (GetRenderStats) and every view's Render stages
+		//! (View::GetRenderStats), trace collects both as Chrome trace events
+		Figure& EnableProfiling(bool enable, std::shared_ptr<profile::Trace> trace = nullptr)
 		{
-			if (row < 0 || col < 0)
+			profiling_ = enable;
+			trace_ = enable ? trace : nullptr;
+			for (auto& view : views_)
 			{
-				throw std::out_of_range("view index out of range");
+				view.EnableProfiling(enable, trace);
 			}
+			return *this;
+		}
 
-			int index = (row - 1) * total_cols_ + col - 1;
-			if (index < 0 || index >= views_.size())
+		//! stage timings of the last profiled frame
+		const profile::FigureStats& GetRenderStats() const
+		{
+			return render_stats_;
+		}
+
+		//! draw the views at factor times their slot size and scale them down (area
+		//! average) into the composite, for smoother output (Save). 1 (default) to 4
+		Figure& SetSupersampling(int factor)
+		{
+			factor = std::max(1, std::min(4, factor));
+			if (supersampling_ != factor)
 			{
-				throw std::out_of_range("view index out of range");
+				supersampling_ = factor;
+				composed_.clear();
 			}
-			views_[index] = view;
 			return *this;
 		}
 
-		View& SelectView(int row, int col)
+		int GetSupersampling() const
 		{
-			int index = (row - 1) * total_cols_ + col - 1;
-			if (index < 0 || index >= views_.size())
-			{
-				throw std::out_of_range("view index out of range");
-			}
+			return supersampling_;
+		}
 
-			return views_[index];
+		//! frame loops (Show with mouse interaction, Poll, Refresh, RunLive) show changed views
+		//! as a quality::Draft at once, and re-render them at full quality one view per frame
+		//! in which nothing changed. Show without interaction and Save* always render in full
+		Figure& EnableProgressive(bool enable = true)
+		{
+			progressive_ = enable;
+			return *this;
 		}
 
-		void Show(std::string title, bool waitKey = true)
+		bool IsProgressive() const
 		{
-			Render_();
-			cv::namedWindow(title, cv::WINDOW_AUTOSIZE);
-			const int SCW = 1920;
-			const int SCH = 800;
-			int x = (SCW - figure_size_.width) / 2;
-			int y = (SCH - figure_size_.height) / 2;
-			x = (x > 0 && x < 200) ? x : 10;
-			y = (y > 0 && y < 200) ? y : 10;
-			cv::moveWindow(title, x, y);
-			if (enable_mouse_move_)
-			{
-				cv::imshow(title, buffer_);
-				mouse::update_window(title, figure_size_);
-				cv::setMouseCallback(title, mouse::event_handler, this);
-			}
-			else
-			{
-				ResetMouseMove(title);
-			}
-			if (waitKey)
-			{
-				cv::waitKey();
-				cv::destroyWindow(title);
-			}
+			return progressive_;
 		}
 
-		void Show(bool waitKey = true)
+		//! true while drafts wait to be refined
+		bool IsRefining() const
 		{
-			Render_();
-			cv::namedWindow(figure_name_, cv::WINDOW_AUTOSIZE);
-			const int SCW = 1920;
-			const int SCH = 800;
-			int x = (SCW - figure_size_.width) / 2;
-			int y = (SCH - figure_size_.height) / 2;
-			x = (x > 0 && x < 200) ? x : 10;
-			y = (y > 0 && y < 200) ? y : 10;
-			cv::moveWindow(figure_name_, x, y);
-			if (enable_mouse_move_)
+			for (auto& view : views_)
 			{
-				cv::imshow(figure_name_, buffer_);
-				mouse::update_window(figure_name_, figure_size_);
-				cv::setMouseCallback(figure_name_, mouse::event_handler, this);
-			}
-			else
-			{
-				ResetMouseMove(figure_name_);
+				if (view.GetQuality() < quality::Full)
+				{
+					return true;
+				}
 			}
-			if (waitKey)
+			return false;
+		}
+
+		//! bytes held by the composite, the status strip and all views (frames and series),
+		//! pixels shared by several Mats are counted once. includes the line rasterizer
+		//! masks, which all figures of the process share
+		size_t GetMemory() const
+		{
+			std::set<const void*> counted;
+			size_t bytes = util::FrameBytes(buffer_, counted) + util::FrameBytes(overlay_, counted)
+				+ raster::Canvas::GetScratchMemory();
+			for (auto& view : views_)
 			{
-				cv::waitKey();
-				cv::destroyWindow(figure_name_);
+				bytes += view.GetMemory_(counted);
 			}
+			return bytes;
 		}
 
 		void Close()
 		{
 			cv::destroyWindow(figure_name_);
+			live_window_ = false;
 		}
 
 		void Save(const std::string& filename)
@@ -1962,15 +8161,18 @@ namespace cvplot
 			Render_();
 			try
 			{
-				if (!render_results_.empty())
+				auto index = filename.find_last_of('.');
+				std::string prefix = filename.substr(0, index);
+				std::string ext = filename.substr(index);
+				for (size_t i = 0; i < views_.size(); ++i)
 				{
-					auto index = filename.find_last_of('.');
-					std::string prefix = filename.substr(0, index);
-					std::string ext = filename.substr(index);
-					for (auto result : render_results_)
+					//! the frames the composite was made of, no copies
+					auto frame = views_[i].GetFrame();
+					if (!frame.empty())
 					{
-						auto filename_1 = prefix + "[" + result.first + "]" + ext;
-						cv::imwrite(filename_1, result.second);
+						char sz[32] = { 0 };
+						snprintf(sz, sizeof(sz), "%02d-%02d", (int)i / total_cols_ + 1, (int)i % total_cols_ + 1);
+						cv::imwrite(prefix + "[" + sz + "]" + ext, frame);
 					}
 				}
 			}
@@ -1988,15 +8190,13 @@ namespace cvplot
 				throw std::out_of_range("view index out of range");
 			}
 
-			Render_();
+			//! only this view is rendered, the others stay untouched (and unloaded if lazy)
+			auto vbuf = views_[index].SetRenderSize(SlotRenderSize_()).Render().GetFrame();
 			try
 			{
-				char sz[8] = { 0 };
-				sprintf_s(sz, "%02d-%02d", row, col);
-				auto result = render_results_.find(sz);
-				if (result != render_results_.end())
+				if (!vbuf.empty())
 				{
-					cv::imwrite(filename, result->second);
+					cv::imwrite(filename, vbuf);
 				}
 			}
 			catch (...)
@@ -2005,68 +8205,179 @@ namespace cvplot
 			}
 		}
 
-		void Dump(const std::string& folder, const std::string alias)
+		void Dump(const std::string& folder, const std::string alias, dump::Encoding encoding = dump::Raw)
 		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, (folder + alias + ".00000000000000.fdp").c_str(), "w");
+			Dump_(folder, alias, encoding);
+		}
+
+		//! incremental Dump for figures that keep growing, Load reads both
+		void Checkpoint(const std::string& folder, const std::string alias)
+		{
+			Dump_(folder, alias, View::CHECKPOINT);
+		}
+
+	private:
+		//! metadata is written serially, the series of all views are then dumped on a worker pool
+		void Dump_(const std::string& folder, const std::string& alias, dump::Encoding encoding)
+		{
+			FILE* fp = util::OpenFile(folder + alias + ".00000000000000.fdp", "w");
 			if (fp)
 			{
-				fprintf_s(fp, "name=%s\n", figure_name_.c_str());
-				fprintf_s(fp, "%d %d\n", total_rows_, total_cols_);
-				fprintf_s(fp, "%d %d\n", figure_size_.width, figure_size_.height);
-				fprintf_s(fp, "%d %d\n", horizontal_margin_, vertical_margin_);
+				std::vector<std::function<void()>> tasks;
+				fprintf(fp, "name=%s\n", figure_name_.c_str());
+				fprintf(fp, "%d %d\n", total_rows_, total_cols_);
+				fprintf(fp, "%d %d\n", figure_size_.width, figure_size_.height);
+				fprintf(fp, "%d %d\n", horizontal_margin_, vertical_margin_);
 				for (int r = 1; r <= total_rows_; ++r)
 				{
 					for (int c = 1; c <= total_cols_; ++c)
 					{
-						auto v = SelectView(r, c);
+						auto& v = SelectView(r, c);
 						char sz[32] = { 0 };
-						sprintf_s(sz, ".%02d-%02d", r, c);
+						snprintf(sz, sizeof(sz), ".%02d-%02d", r, c);
 						auto prefix = folder + alias + sz;
-						v.Dump(prefix);
-						fprintf_s(fp, "%s\n", prefix.c_str());
+						v.Dump_(prefix, encoding, tasks);
+						fprintf(fp, "%s\n", prefix.c_str());
 					}
 				}
 				fclose(fp);
+				util::ParallelFor(tasks.size(), [&tasks](size_t i) { tasks[i](); });
 			}
 		}
 
-		void Load(const std::string& folder, const std::string alias, bool filterInfNaN = true)
+	public:
+		//! series of all views are loaded on a worker pool, then added view by view
+		//! in file order, so the result does not depend on the thread count.
+		//! lazy: read the metadata only, each view loads its series and allocates its
+		//! buffer on first render (SaveView renders that view only) or SelectSeries.
+		//! if folder + alias is a pack it is loaded with LoadPack instead (never lazy)
+		void Load(const std::string& folder, const std::string alias, bool filterInfNaN = true, bool mapped = false, bool lazy = false)
 		{
-			FILE* fp = nullptr;
-			fopen_s(&fp, (folder + alias + ".00000000000000.fdp").c_str(), "r");
+			if (pack::IsPack(folder + alias))
+			{
+				LoadPack(folder + alias, filterInfNaN, mapped);
+				return;
+			}
+
+			FILE* fp = util::OpenFile(folder + alias + ".00000000000000.fdp", "r");
 			if (fp == nullptr)
 			{
-				throw std::exception("load figure failed");
+				throw std::runtime_error("load figure failed");
 			}
 
-			const int LEN = 256;
-			char sz[LEN] = { 0 };
-			fscanf_s(fp, "%[^\n]", sz, LEN);
-			figure_name_ = std::string(sz).substr(5); //! cut "name="
+			std::string line;
+			util::ReadLine(fp, line);
+			figure_name_ = line.substr(std::min<size_t>(5, line.size())); //! cut "name="
 			int rows;
 			int cols;
-			fscanf_s(fp, "%d %d\n", &rows, &cols);
+			util::ScanFile(fp, "%d %d\n", &rows, &cols);
 			SetLayout(rows, cols);
 			int width;
 			int height;
-			fscanf_s(fp, "%d %d\n", &width, &height);
+			util::ScanFile(fp, "%d %d\n", &width, &height);
 			SetSize({ width,height });
-			fscanf_s(fp, "%d %d\n", &horizontal_margin_, &vertical_margin_);
+			util::ScanFile(fp, "%d %d\n", &horizontal_margin_, &vertical_margin_);
+			fclose(fp);
+
+			struct Task
+			{
+				int view;
+				std::string filename;
+			};
+			std::vector<Task> tasks;
 			for (int r = 1; r <= rows; ++r)
 			{
 				for (int c = 1; c <= cols; ++c)
 				{
-					View v;
 					char sz[32] = { 0 };
-					sprintf_s(sz, ".%02d-%02d", r, c);
+					snprintf(sz, sizeof(sz), ".%02d-%02d", r, c);
 					auto prefix = folder + alias + sz;
-					v.Load(prefix, filterInfNaN);
-					SetView(v, r, c);
-					SelectView(r, c).Invalidate();
+					auto index = (r - 1) * cols + c - 1;
+					auto filenames = views_[index].LoadMeta_(prefix, lazy);
+					if (lazy)
+					{
+						views_[index].LoadPending_(filenames, filterInfNaN, mapped);
+						continue;
+					}
+					for (auto& filename : filenames)
+					{
+						tasks.push_back({ index, filename });
+					}
+				}
+			}
+
+			std::vector<Series> loaded(tasks.size());
+			util::ParallelFor(tasks.size(), [&](size_t i)
+			{
+				View::LoadSeries_(loaded[i], tasks[i].filename, filterInfNaN, mapped);
+			});
+			for (size_t i = 0; i < tasks.size(); ++i)
+			{
+				views_[tasks[i].view].AddSeries(std::move(loaded[i]));
+			}
+			for (auto& v : views_)
+			{
+				v.Invalidate();
+			}
+		}
+
+		//! render and copy the composited figure into a shared memory ring
+		uint64_t Publish(shm::Publisher& publisher)
+		{
+			Render_();
+			return publisher.Publish(buffer_);
+		}
+
+		//! dump the whole figure into a single file (see cvplot::pack)
+		void DumpPack(const std::string& filename, pack::Flags flags = pack::None)
+		{
+			pack::Writer writer(filename, flags);
+			pack::Buffer buffer;
+			buffer.PutString(figure_name_)
+				.PutInt(total_rows_)
+				.PutInt(total_cols_)
+				.PutInt(figure_size_.width)
+				.PutInt(figure_size_.height)
+				.PutInt(horizontal_margin_)
+				.PutInt(vertical_margin_);
+			writer.Write(pack::block::Figure, 0, 0, buffer);
+			for (uint32_t i = 0; i < views_.size(); ++i)
+			{
+				views_[i].DumpPack(writer, i);
+			}
+			writer.Close();
+		}
+
+		//! load a figure in one sequential pass over the pack, or from a file mapping
+		void LoadPack(const std::string& filename, bool filterInfNaN = true, bool mapped = false)
+		{
+			pack::Reader reader(filename, mapped);
+			pack::BlockHeader header;
+			Series pending;
+			while (reader.Next(header))
+			{
+				if (header.kind == pack::block::Figure)
+				{
+					auto buffer = reader.ReadBuffer(header);
+					figure_name_ = buffer.GetString();
+					int rows = buffer.GetInt();
+					int cols = buffer.GetInt();
+					int width = buffer.GetInt();
+					int height = buffer.GetInt();
+					horizontal_margin_ = buffer.GetInt();
+					vertical_margin_ = buffer.GetInt();
+					SetLayout(rows, cols);
+					SetSize({ width,height });
+				}
+				else if (header.view < views_.size())
+				{
+					views_[header.view].LoadPack(reader, header, pending, filterInfNaN);
+				}
+				else
+				{
+					throw std::runtime_error("corrupted pack");
 				}
 			}
-			fclose(fp);
 		}
 
 		void EnableMouseMove(bool enable)
@@ -2074,79 +8385,187 @@ namespace cvplot
 			enable_mouse_move_ = enable;
 		}
 
+		//! records the position, the status strip is drawn once per frame (DrawHover_) by
+		//! Poll/RunLive/Show, or right away when nothing pumps frames (Show without waitKey)
 		void OnMouseMove(int x, int y, std::string& window_name)
 		{
-			cv::Rect rect(0, figure_size_.height - vertical_margin_, figure_size_.width, vertical_margin_);
-			cv::Mat m(vertical_margin_, figure_size_.width, CV_8UC4, background_color_.ToScalar());
-			m.copyTo(buffer_(rect));
-
-			if (x<horizontal_margin_ || x>figure_size_.width - horizontal_margin_
-				|| y<vertical_margin_ || y>figure_size_.height - vertical_margin_)
+			if (!enable_mouse_move_)
 			{
 				return;
 			}
+			hover_ = { x, y };
+			hover_pending_ = true;
+			if (!live_window_ && !pumping_ && DrawHover_())
+			{
+				cv::imshow(window_name, buffer_);
+			}
+		}
 
-			std::ostringstream oss;
-			oss << "M(" << x << "," << y << ")";
+		//! wheel zooms the view under the cursor, dragging pans it, double click resets it
+		void EnableZoomPan(bool enable)
+		{
+			enable_zoom_pan_ = enable;
+		}
 
-			Color textColor = color::White;
+		void OnMouseWheel(int x, int y, int delta, std::string& window_name)
+		{
+			const double STEP = 1.25;
 			double vx = 0;
 			double vy = 0;
 			auto loc = ViewPoint_(x, y, vx, vy);
-			if (loc.x > 0 && loc.y > 0)
+			if (!enable_zoom_pan_ || delta == 0 || loc.x < 1)
 			{
-				auto view = SelectView(loc.x, loc.y);
-				oss << " V(" << view.GetTitle() << ") " << view.Capture(vx, vy);
-				auto cr = view.GetTextColor();
-				textColor = cr;
+				return;
 			}
+			SelectView(loc.x, loc.y).Zoom(vx, vy, delta > 0 ? STEP : 1.0 / STEP);
+			ShowInteraction_(window_name);
+		}
 
-			auto str = oss.str();
-
-			auto fface = cv::FONT_HERSHEY_PLAIN;
-			int fbase;
-			cv::Size fsize = cv::getTextSize(str, fface, 1.0, 1, &fbase);
+		void OnMouseDrag(int x, int y, int dx, int dy, std::string& window_name)
+		{
+			double vx = 0;
+			double vy = 0;
+			auto loc = ViewPoint_(x, y, vx, vy);
+			if (!enable_zoom_pan_ || loc.x < 1)
+			{
+				return;
+			}
+			auto& view = SelectView(loc.x, loc.y);
+			auto actual_size = view.GetSize();
+			view.Pan((double)dx * actual_size.width / view_size_.width, (double)dy * actual_size.height / view_size_.height);
+			ShowInteraction_(window_name);
+		}
 
-			cv::rectangle(buffer_,
-				{
-					rect.width / 2 - fsize.width / 2 - 5,
-					figure_size_.height - vertical_margin_ + 2,
-					fsize.width + 10,
-					vertical_margin_ - 2
-				},
-				textColor.Cut(64).ToScalar(), -1);
-			cv::putText(buffer_, str,
-				{
-					rect.width / 2 - fsize.width / 2,
-					figure_size_.height - fsize.height + fbase
-				},
-				fface, 1.0,
-				textColor.Lift(192).ToScalar());
-			cv::imshow(window_name, buffer_);
+		void OnMouseDoubleClick(int x, int y, std::string& window_name)
+		{
+			double vx = 0;
+			double vy = 0;
+			auto loc = ViewPoint_(x, y, vx, vy);
+			if (!enable_zoom_pan_ || loc.x < 1)
+			{
+				return;
+			}
+			SelectView(loc.x, loc.y).ResetViewport();
+			ShowInteraction_(window_name);
 		}
 
 		void ResetMouseMove(std::string& window_name)
 		{
+			hover_ = { -1, -1 };
+			hover_pending_ = false;
 			cv::Rect rect(0, figure_size_.height - vertical_margin_, figure_size_.width, vertical_margin_);
-			cv::Mat m(vertical_margin_, figure_size_.width, CV_8UC4, background_color_.ToScalar());
-			m.copyTo(buffer_(rect));
+			buffer_(rect).setTo(background_color_.ToScalar());
 			cv::imshow(window_name, buffer_);
 		}
 
 	private:
-		void Render_()
+		//! after a zoom/pan: the frame loops pick the dirty view up, otherwise re-render now
+		void ShowInteraction_(std::string& window_name)
+		{
+			if (live_window_ || pumping_)
+			{
+				return;
+			}
+			Render_();
+			DrawHover_();
+			cv::imshow(window_name, buffer_);
+		}
+
+		void OpenWindow_(std::string title)
+		{
+			cv::namedWindow(title, cv::WINDOW_AUTOSIZE);
+			const int SCW = 1920;
+			const int SCH = 800;
+			int x = (SCW - figure_size_.width) / 2;
+			int y = (SCH - figure_size_.height) / 2;
+			x = (x > 0 && x < 200) ? x : 10;
+			y = (y > 0 && y < 200) ? y : 10;
+			cv::moveWindow(title, x, y);
+			if (enable_mouse_move_ || enable_zoom_pan_)
+			{
+				cv::imshow(title, buffer_);
+				mouse::update_window(title, figure_size_);
+				cv::setMouseCallback(title, mouse::event_handler, this);
+			}
+			else
+			{
+				ResetMouseMove(title);
+			}
+		}
+
+		//! render and show the figure window, the window is opened by the first frame
+		void Present_()
+		{
+			bool changed = RenderProgressive_();
+			changed = DrawHover_() || changed;
+			if (!live_window_)
+			{
+				OpenWindow_(figure_name_);
+				live_window_ = true;
+				++frame_stats_.presented;
+			}
+			else if (changed)
+			{
+				cv::imshow(figure_name_, buffer_);
+				++frame_stats_.presented;
+			}
+		}
+
+		double FinishFrame_(std::chrono::steady_clock::time_point start, double budget)
 		{
-			bool dirty_ = false;
-			for (auto view : views_)
+			auto now = std::chrono::steady_clock::now();
+			auto elapsed = std::chrono::duration<double, std::milli>(now - start).count();
+			auto& stats = frame_stats_;
+			if (stats.frames > 0)
 			{
-				if (view.IsDirty())
+				auto interval = std::chrono::duration<double, std::milli>(start - last_frame_).count();
+				if (interval > 0)
 				{
-					dirty_ = true;
-					break;
+					stats.fps = stats.fps > 0 ? 0.9 * stats.fps + 0.1 * 1000.0 / interval : 1000.0 / interval;
 				}
 			}
+			stats.avg_ms = stats.frames > 0 ? 0.9 * stats.avg_ms + 0.1 * elapsed : elapsed;
+			stats.max_ms = std::max(stats.max_ms, elapsed);
+			stats.last_ms = elapsed;
+			if (budget > 0 && elapsed > budget)
+			{
+				++stats.late;
+			}
+			++stats.frames;
+			last_frame_ = start;
+			return elapsed;
+		}
 
-			if (dirty_)
+		//! progressive: changed views are drafted, a frame with no change refines one view.
+		//! otherwise Render_. true if the composite changed
+		bool RenderProgressive_()
+		{
+			if (!progressive_)
+			{
+				return Render_();
+			}
+			return Render_(quality::Draft) || Render_(quality::Full, 1);
+		}
+
+		//! views render at the size they get on the composite, times the supersampling factor
+		cv::Size SlotRenderSize_() const
+		{
+			return { view_size_.width * supersampling_, view_size_.height * supersampling_ };
+		}
+
+		//! re-render the dirty views (and those drawn below quality) and copy only those
+		//! (and views never shown) into the composite, at most limit views. true if the
+		//! composite changed
+		bool Render_(quality::Type quality = quality::Full, int limit = INT_MAX)
+		{
+			if (composed_.size() != views_.size())
+			{
+				composed_.assign(views_.size(), false);
+			}
+
+			profile::Laps laps(profiling_, trace_.get());
+			profile::FigureStats stats;
+			bool changed = false;
 			{
 				cv::Rect roi(horizontal_margin_, vertical_margin_, view_size_.width, view_size_.height);
 
@@ -2156,30 +8575,42 @@ namespace cvplot
 					roi.x = horizontal_margin_;
 					for (int c = 1; c <= total_cols_; ++c)
 					{
-						auto vbuf = views_[index].Render().GetBuffer();
+						auto& view = views_[index];
+						view.SetRenderSize(SlotRenderSize_());
+						bool dirty = view.Drain() || view.IsDirty() || view.GetQuality() < quality;
+						laps.Mark(stats.drain, "drain");
+						if ((!dirty && composed_[index]) || stats.views >= limit)
+						{
+							++index;
+							roi.x += (view_size_.width + horizontal_margin_);
+							continue;
+						}
+
+						if (profiling_ && !view.IsProfiling())
+						{
+							//! views replaced or added since EnableProfiling
+							view.EnableProfiling(true, trace_);
+						}
+						view.Render(quality);
+						laps.Mark(stats.render, "render", view.GetTitle());
+						++stats.views;
+						composed_[index] = true;
+						changed = true;
+						//! read the view's pixels in place, each composite pixel is written once.
+						//! views are drawn at the slot size, only supersampled ones get scaled
+						const auto& vbuf = view.buffer_;
 						if (!vbuf.empty())
 						{
-							char sz[8] = { 0 };
-							sprintf_s(sz, "%02d-%02d", r, c);
-							if (render_results_.find(sz) == render_results_.end())
-							{
-								render_results_.insert({ sz, vbuf });
-							}
-							else
-							{
-								render_results_[sz] = vbuf;
-							}
 							auto m = buffer_(roi);
 							if (vbuf.rows != view_size_.height || vbuf.cols != view_size_.width)
 							{
-								cv::Mat tmp(view_size_, CV_8UC4);
-								cv::resize(vbuf, tmp, view_size_, cv::INTER_NEAREST);
-								tmp.copyTo(m);
-								tmp.release();
+								cv::resize(vbuf, m, view_size_, 0, 0, cv::INTER_AREA);
+								laps.Mark(stats.resize, "resize");
 							}
 							else
 							{
 								vbuf.copyTo(m);
+								laps.Mark(stats.copy, "copy");
 							}
 						}
 						++index;
@@ -2187,44 +8618,111 @@ namespace cvplot
 					}
 					roi.y += (view_size_.height + vertical_margin_);
 				}
+			}
 
-				dirty_ = false;
+			if (laps.IsEnabled())
+			{
+				laps.Finish(stats.total, "Figure::Render");
+				stats.frames = render_stats_.frames + 1;
+				render_stats_ = stats;
 			}
+			return changed;
 		}
 
-		cv::Point2i ViewPoint_(int x, int y, double& view_x, double& view_y)
+		//! redraw the status strip (bottom margin) for the last hover position, once per
+		//! frame no matter how many mouse events arrived. true if buffer_ changed
+		bool DrawHover_()
 		{
-			int xmin = 0, xmax = 0;
-			int ymin = 0, ymax = 0;
+			if (!hover_pending_)
+			{
+				return false;
+			}
+			hover_pending_ = false;
 
-			int col = -1;
-			for (int i = 1; i <= total_cols_; ++i)
+			cv::Rect rect(0, figure_size_.height - vertical_margin_, figure_size_.width, vertical_margin_);
+			if (rect.height <= 0 || rect.y < 0)
+			{
+				return false;
+			}
+			if (overlay_.size() != rect.size())
+			{
+				overlay_ = cv::Mat(rect.size(), CV_8UC4);
+			}
+			overlay_.setTo(background_color_.ToScalar());
+
+			auto x = hover_.x;
+			auto y = hover_.y;
+			if (!(x<horizontal_margin_ || x>figure_size_.width - horizontal_margin_
+				|| y<vertical_margin_ || y>figure_size_.height - vertical_margin_))
 			{
-				xmin = (i - 1) * (view_size_.width + horizontal_margin_) + horizontal_margin_;
-				xmax = xmin + view_size_.width;
-				if (xmin <= x && x <= xmax)
+				std::ostringstream oss;
+				oss << "M(" << x << "," << y << ")";
+
+				Color textColor = color::White;
+				double vx = 0;
+				double vy = 0;
+				auto loc = ViewPoint_(x, y, vx, vy);
+				if (loc.x > 0 && loc.y > 0)
 				{
-					col = i;
-					break;
+					auto& view = SelectView(loc.x, loc.y);
+					oss << " V(" << view.GetTitle() << ") " << view.Capture(vx, vy);
+					auto cr = view.GetTextColor();
+					textColor = cr;
 				}
+
+				auto str = oss.str();
+
+				auto fface = cv::FONT_HERSHEY_PLAIN;
+				int fbase;
+				cv::Size fsize = cv::getTextSize(str, fface, 1.0, 1, &fbase);
+
+				cv::rectangle(overlay_,
+					{
+						rect.width / 2 - fsize.width / 2 - 5,
+						2,
+						fsize.width + 10,
+						vertical_margin_ - 2
+					},
+					textColor.Cut(64).ToScalar(), -1);
+				cv::putText(overlay_, str,
+					{
+						rect.width / 2 - fsize.width / 2,
+						vertical_margin_ - fsize.height + fbase
+					},
+					fface, 1.0,
+					textColor.Lift(192).ToScalar());
 			}
 
+			overlay_.copyTo(buffer_(rect));
+			return true;
+		}
+
+		//! cell lookup by division instead of scanning rows and columns
+		cv::Point2i ViewPoint_(int x, int y, double& view_x, double& view_y)
+		{
 			int row = -1;
-			for (int i = 1; i <= total_rows_; ++i)
+			int col = -1;
+			int xmin = 0;
+			int ymin = 0;
+			auto x_stride = view_size_.width + horizontal_margin_;
+			auto y_stride = view_size_.height + vertical_margin_;
+			if (x >= horizontal_margin_ && y >= vertical_margin_ && x_stride > 0 && y_stride > 0)
 			{
-				ymin = (i - 1) * (view_size_.height + vertical_margin_) + vertical_margin_;
-				ymax = ymin + view_size_.height;
-				if (ymin <= y && y <= ymax)
+				auto c = (x - horizontal_margin_) / x_stride;
+				auto r = (y - vertical_margin_) / y_stride;
+				xmin = c * x_stride + horizontal_margin_;
+				ymin = r * y_stride + vertical_margin_;
+				if (x - xmin <= view_size_.width && y - ymin <= view_size_.height)
 				{
-					row = i;
-					break;
+					col = c + 1;
+					row = r + 1;
 				}
 			}
 
-			int index = (row - 1) * total_cols_ + col - 1;
 			if (row > 0 && row <= total_rows_ && col > 0 && col <= total_cols_
 				&& view_size_.width > 1 && view_size_.height > 1)
 			{
+				int index = (row - 1) * total_cols_ + col - 1;
 				auto actual_size = views_[index].GetSize();
 				view_x = (double)(x - xmin) * actual_size.width / view_size_.width;
 				view_y = (double)(y - ymin) * actual_size.height / view_size_.height;
@@ -2240,7 +8738,6 @@ namespace cvplot
 
 	private:
 		std::vector<View> views_;
-		std::map<std::string, cv::Mat> render_results_;
 		std::string figure_name_;
 		cv::Size figure_size_;
 		cv::Size view_size_;
@@ -2251,6 +8748,20 @@ namespace cvplot
 		int vertical_margin_;
 		cv::Mat buffer_;
 		bool enable_mouse_move_;
+		bool enable_zoom_pan_;
+		std::vector<bool> composed_; //! views copied into buffer_ since the last layout change
+		bool live_window_;
+		live::FrameStats frame_stats_;
+		std::chrono::steady_clock::time_point last_frame_;
+		cv::Point hover_;            //! last mouse position, drawn by DrawHover_
+		bool hover_pending_;
+		bool pumping_;               //! Show is running its own event loop
+		cv::Mat overlay_;            //! status strip
+		bool profiling_;
+		std::shared_ptr<profile::Trace> trace_;
+		profile::FigureStats render_stats_;
+		int supersampling_;
+		bool progressive_;
 	};
 
 }
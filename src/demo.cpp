@@ -1,5 +1,5 @@
 #include "cvplot.h"
-#include <direct.h>
+#include <filesystem>
 
 void create_directory(const std::string dir);
 
@@ -92,10 +92,10 @@ int main()
 
 	//f.Show();
 	//f.Save("figure.png");
-	create_directory("dump\\");
-	f.Dump("dump\\", "fig1");
+	create_directory("dump/");
+	f.Dump("dump/", "fig1");
 
-	build_figure("dump\\", "fig1");
+	build_figure("dump/", "fig1");
 }
 
 void create_directory(const std::string dir)
@@ -105,40 +105,8 @@ void create_directory(const std::string dir)
 		return;
 	}
 
-	auto pos = dir.find_first_of(':');
-	if (pos == dir.npos)
-	{
-		pos = 0;
-	}
-	else
-	{
-		pos += 1;
-	}
-
-	auto pos_ = dir.find('\\', pos + 1);
-	if (pos_ == dir.npos)
-	{
-		pos_ = dir.find('/', pos + 1);
-	}
-	pos = pos_;
-
-	if (pos == dir.npos)
-	{
-		_mkdir(dir.c_str());
-		return;
-	}
-
-	do
-	{
-		auto s = dir.substr(0, pos);
-		_mkdir(s.c_str());
-		auto pos_ = dir.find('\\', pos + 1);
-		if (pos_ == dir.npos)
-		{
-			pos_ = dir.find('/', pos + 1);
-		}
-		pos = pos_;
-	} while (pos != dir.npos);
+	std::error_code ec;
+	std::filesystem::create_directories(dir, ec);
 }
 
 void build_figure(const std::string folder, const std::string alias)